@@ -0,0 +1,77 @@
+#ifndef BENCH_UTILS_H
+#define BENCH_UTILS_H
+
+// Fixtures shared by the benchmarks: synthetic grayscale images and a median-of-runs timer.
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include "ImageIO.h"
+
+namespace bench {
+
+/**
+ * @brief Square 8-bit grayscale image whose pixel (r, c) is pixel(r, c, rng), clamped to [0, 255].
+ *
+ * The generator is seeded the same way on every call, so every run times the same image.
+ */
+template <typename PixelFunction>
+ImageReadResult makeSyntheticImage(int size, PixelFunction pixel) {
+    ImageReadResult image;
+    image.meta = ImageMetadata(size, size, 8);
+
+    std::mt19937 rng(12345);
+    std::vector<uint8_t> buffer(static_cast<size_t>(size) * size);
+    for (int r = 0; r < size; ++r) {
+        for (int c = 0; c < size; ++c) {
+            int value = static_cast<int>(pixel(r, c, rng));
+            buffer[static_cast<size_t>(r) * size + c] = static_cast<uint8_t>(std::clamp(value, 0, 255));
+        }
+    }
+    image.buffer = buffer;
+    return image;
+}
+
+// Smooth gradient plus noise, so the histograms are neither flat nor a single spike
+inline ImageReadResult makeSyntheticImage(int size) {
+    return makeSyntheticImage(size, [](int r, int c, std::mt19937& rng) {
+        return static_cast<uint8_t>((r + c) / 8 + rng() % 64);
+    });
+}
+
+/**
+ * @brief Median of several timed runs of run(), in milliseconds, after one warm-up run.
+ *
+ * The library logs to std::cout, so it is muted while timing (and left as it was found afterwards).
+ */
+template <typename Run>
+double timeRuns(Run&& run, int repetitions) {
+    std::vector<double> timings;
+    std::ios_base::iostate coutState = std::cout.rdstate();
+    std::cout.setstate(std::ios_base::failbit);
+
+    run();  // warm-up
+    for (int rep = 0; rep < repetitions; ++rep) {
+        auto start = std::chrono::steady_clock::now();
+        run();
+        auto end = std::chrono::steady_clock::now();
+        timings.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    }
+
+    std::cout.clear(coutState);
+    std::sort(timings.begin(), timings.end());
+    return timings[timings.size() / 2];
+}
+
+// Same, keeping the result of the last run in output
+template <typename Run, typename Output>
+double timeRuns(Run&& run, int repetitions, Output& output) {
+    return timeRuns([&] { output = run(); }, repetitions);
+}
+
+} // namespace bench
+
+#endif // BENCH_UTILS_H
@@ -0,0 +1,81 @@
+// Canny edge detection: the staged engine (one full-size buffer per stage) against the fused streaming
+// engine and its tiled variant. The fused engines do not round the smoothed image to 8 bits, so their edges
+// are not expected to match the staged ones pixel for pixel; the share of pixels that differ is printed for
+// reference. The tiled engine must match the fused one exactly.
+//
+// Usage: CannyBenchmark [imageSize=4096] [repetitions=5]
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "ImageIO.h"
+#include "ImageEdgeDetection.h"
+#include "ThreadPool.h"
+#include "BenchUtils.h"
+
+int main(int argc, char* argv[]) {
+    int size = (argc > 1) ? std::atoi(argv[1]) : 4096;
+    int repetitions = (argc > 2) ? std::atoi(argv[2]) : 5;
+
+    if (size <= 0 || repetitions <= 0) {
+        std::cerr << "Usage: CannyBenchmark [imageSize] [repetitions]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Smooth shapes plus noise, so there are long edges as well as weak responses for the hysteresis
+    ImageReadResult image = bench::makeSyntheticImage(size, [](int r, int c, std::mt19937& rng) {
+        bool inside = ((r / 97) + (c / 131)) % 2 == 0;
+        return (inside ? 150 : 60) + static_cast<int>(rng() % 40);
+    });
+    double megapixels = static_cast<double>(size) * size / 1e6;
+
+    // Bytes per pixel of the full-size buffers each engine allocates: the staged one keeps the float
+    // horizontal Gaussian pass, the 8-bit smoothed image, float magnitude, direction and suppressed
+    // magnitudes and the 8-bit output; the fused one the output, plus the union-find of the hysteresis
+    // on several threads; the tiled one only the output
+    int hysteresisBytes = (sharedThreadPool().threadCount() > 1) ? 4 : 0;
+    std::vector<std::pair<CannyEngine, std::pair<const char*, int>>> engines = {
+        {CannyEngine::STAGED, {"staged", 4 + 1 + 4 + 4 + 4 + 1 + hysteresisBytes}},
+        {CannyEngine::FUSED, {"fused", 1 + hysteresisBytes}},
+        {CannyEngine::TILED, {"tiled", 1}},
+    };
+
+    std::cout << "Canny benchmark, " << size << "x" << size << ", median of " << repetitions << " runs\n";
+    std::cout << std::left << std::setw(12) << "engine" << std::setw(12) << "ms" << std::setw(12) << "MP/s"
+              << std::setw(10) << "speedup" << std::setw(14) << "buffers B/px" << "differs from staged\n";
+
+    std::vector<uint8_t> staged;
+    std::vector<uint8_t> fused;
+    bool tiledMatches = true;
+    double stagedMs = 0.0;
+    for (const auto& [engine, description] : engines) {
+        std::vector<uint8_t> output;
+        double ms = bench::timeRuns([&, engine = engine] {
+            return applyCannyEdgeDetection(image, 20, 60, 1.4, 5, PaddingChoice::REPLICATE, engine);
+        }, repetitions, output);
+
+        if (engine == CannyEngine::STAGED) {
+            staged = output;
+            stagedMs = ms;
+        } else if (engine == CannyEngine::FUSED) {
+            fused = output;
+        } else {
+            tiledMatches = (output == fused);
+        }
+        size_t differing = 0;
+        for (size_t i = 0; i < output.size(); ++i) {
+            differing += (output[i] != staged[i]) ? 1 : 0;
+        }
+
+        std::cout << std::left << std::fixed << std::setprecision(2)
+                  << std::setw(12) << description.first << std::setw(12) << ms
+                  << std::setw(12) << megapixels / (ms / 1000.0) << std::setw(10) << stagedMs / ms
+                  << std::setw(14) << description.second
+                  << 100.0 * static_cast<double>(differing) / static_cast<double>(output.size()) << "%\n";
+    }
+
+    std::cout << "tiled matches fused: " << (tiledMatches ? "yes" : "NO") << "\n";
+    return tiledMatches ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,103 @@
+// Throughput of the 3x3 convolution engine at every instruction-set level the CPU supports,
+// for the raw engine and for the filters built on it. Outputs are checked against the scalar level.
+//
+// Usage: ConvolutionBenchmark [imageSize=2048] [repetitions=5]
+
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "ImageIO.h"
+#include "ImageFilter.h"
+#include "ImageEdgeDetection.h"
+#include "Convolution3x3.h"
+#include "BenchUtils.h"
+
+namespace {
+
+struct Workload {
+    std::string name;
+    std::function<std::vector<uint8_t>(const ImageReadResult&)> run;
+};
+
+// Runs the engine alone over every interior row; no allocation apart from the output
+std::vector<uint8_t> engineOnly(const ImageReadResult& image, const Kernel3x3& kernel) {
+    int rows = image.meta.height;
+    int cols = image.meta.width;
+    const uint8_t* buffer = image.buffer->data();
+
+    std::vector<uint8_t> output(static_cast<size_t>(rows) * cols, 0);
+    for (int i = 1; i < rows - 1; ++i) {
+        const uint8_t* window[3] = {
+            buffer + static_cast<size_t>(i - 1) * cols,
+            buffer + static_cast<size_t>(i) * cols,
+            buffer + static_cast<size_t>(i + 1) * cols
+        };
+        convolveRow3x3Saturate(window, cols - 2, kernel, output.data() + static_cast<size_t>(i) * cols + 1);
+    }
+    return output;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int size = (argc > 1) ? std::atoi(argv[1]) : 2048;
+    int repetitions = (argc > 2) ? std::atoi(argv[2]) : 5;
+
+    if (size <= 0 || repetitions <= 0) {
+        std::cerr << "Usage: ConvolutionBenchmark [imageSize] [repetitions]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const Kernel3x3 fullLaplacian = {{{1, 1, 1}, {1, -8, 1}, {1, 1, 1}}};
+    const Kernel3x3 sobelX = {{{-1, 0, 1}, {-2, 0, 2}, {-1, 0, 1}}};
+
+    std::vector<Workload> workloads = {
+        {"engine laplacian",  [&](const ImageReadResult& img) { return engineOnly(img, fullLaplacian); }},
+        {"engine sobel-x",    [&](const ImageReadResult& img) { return engineOnly(img, sobelX); }},
+        {"high-pass",         [](const ImageReadResult& img) { return applyHighPassFilter(img, 2); }},
+        {"sharpening",        [](const ImageReadResult& img) { return applyImageSharpening(img, 2); }},
+        {"gradient sobel",    [](const ImageReadResult& img) {
+            return applyGradientEdgeDetection(img, KernelChoice::SOBEL, true, 100.0, PaddingChoice::REPLICATE); }},
+        {"gradient roberts",  [](const ImageReadResult& img) {
+            return applyGradientEdgeDetection(img, KernelChoice::ROBERTS, true, 100.0, PaddingChoice::REPLICATE); }},
+    };
+
+    ImageReadResult image = bench::makeSyntheticImage(size);
+    double megapixels = static_cast<double>(size) * size / 1e6;
+    SimdLevel best = detectSimdLevel();
+
+    std::cout << "3x3 convolution benchmark, " << size << "x" << size << ", median of " << repetitions
+              << " runs, CPU supports up to " << simdLevelName(best) << "\n";
+    std::cout << std::left << std::setw(20) << "workload" << std::setw(10) << "ISA"
+              << std::setw(12) << "ms" << std::setw(12) << "MP/s" << std::setw(10) << "speedup" << "match\n";
+
+    bool allMatch = true;
+    for (const Workload& workload : workloads) {
+        std::vector<uint8_t> reference;
+        double scalarMs = 0.0;
+
+        for (int level = 0; level <= static_cast<int>(best); ++level) {
+            setSimdLevel(static_cast<SimdLevel>(level));
+
+            std::vector<uint8_t> output;
+            double ms = bench::timeRuns([&] { return workload.run(image); }, repetitions, output);
+            if (level == 0) {
+                reference = output;
+                scalarMs = ms;
+            }
+            bool match = (output == reference);
+            allMatch = allMatch && match;
+
+            std::cout << std::left << std::fixed << std::setprecision(2)
+                      << std::setw(20) << workload.name << std::setw(10) << simdLevelName(activeSimdLevel())
+                      << std::setw(12) << ms << std::setw(12) << megapixels / (ms / 1000.0)
+                      << std::setw(10) << scalarMs / ms << (match ? "yes" : "NO") << "\n";
+        }
+    }
+
+    setSimdLevel(best);
+    return allMatch ? EXIT_SUCCESS : EXIT_FAILURE;
+}
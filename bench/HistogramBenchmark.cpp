@@ -0,0 +1,111 @@
+// Histogram engine against the single-counter loop it replaced, on noisy and on flat images (long runs
+// of one value are where a single counter stalls), for grayscale and for 24-bit images.
+// Counts are checked against the reference loop. CLAHE is timed against global equalization, which it
+// should stay within a small factor of.
+//
+// Usage: HistogramBenchmark [imageSize=4096] [repetitions=5]
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "ImageIO.h"
+#include "ImageView.h"
+#include "ImageHistogram.h"
+#include "BenchUtils.h"
+
+namespace {
+
+using Histograms = std::vector<std::vector<uint64_t>>;
+
+// flat: a few large regions of one value each; otherwise noise
+std::vector<uint8_t> makeSyntheticSamples(int size, int channels, bool flat) {
+    std::mt19937 rng(12345);
+    std::vector<uint8_t> buffer(static_cast<size_t>(size) * size * channels);
+    for (size_t i = 0; i < buffer.size(); ++i) {
+        size_t pixel = i / channels;
+        int r = static_cast<int>(pixel / size);
+        buffer[i] = flat ? static_cast<uint8_t>((r / 512) * 40) : static_cast<uint8_t>(rng());
+    }
+    return buffer;
+}
+
+// One counter per value, one increment per sample, one pass per channel (how rgbHistogram used to work)
+Histograms referenceHistograms(const ImageView& view) {
+    Histograms histograms(view.channels, std::vector<uint64_t>(256, 0));
+    for (int c = 0; c < view.channels; ++c) {
+        for (int r = 0; r < view.height; ++r) {
+            const uint8_t* row = view.row(r);
+            for (int j = 0; j < view.width; ++j) {
+                histograms[c][row[j * view.channels + c]]++;
+            }
+        }
+    }
+    return histograms;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int size = (argc > 1) ? std::atoi(argv[1]) : 4096;
+    int repetitions = (argc > 2) ? std::atoi(argv[2]) : 5;
+
+    if (size <= 0 || repetitions <= 0) {
+        std::cerr << "Usage: HistogramBenchmark [imageSize] [repetitions]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    double megapixels = static_cast<double>(size) * size / 1e6;
+
+    std::cout << "Histogram benchmark, " << size << "x" << size << ", median of " << repetitions << " runs\n";
+    std::cout << std::left << std::setw(16) << "image" << std::setw(12) << "method"
+              << std::setw(12) << "ms" << std::setw(12) << "MP/s" << std::setw(10) << "speedup" << "match\n";
+
+    bool allMatch = true;
+    for (int channels : {1, 3}) {
+        for (bool flat : {false, true}) {
+            std::vector<uint8_t> samples = makeSyntheticSamples(size, channels, flat);
+            ImageView view = makeImageView(static_cast<const uint8_t*>(samples.data()), size, size, channels);
+            std::string name = std::string(channels == 1 ? "gray " : "bgr ") + (flat ? "flat" : "noise");
+
+            Histograms expected;
+            Histograms output;
+            double referenceMs = bench::timeRuns([&] { return referenceHistograms(view); }, repetitions, expected);
+            double engineMs = bench::timeRuns([&] { return computeChannelHistograms(view); }, repetitions, output);
+            bool match = (output == expected);
+            allMatch = allMatch && match;
+
+            for (auto [method, ms] : {std::pair<const char*, double>{"reference", referenceMs}, {"engine", engineMs}}) {
+                std::cout << std::left << std::fixed << std::setprecision(2)
+                          << std::setw(16) << name << std::setw(12) << method
+                          << std::setw(12) << ms << std::setw(12) << megapixels / (ms / 1000.0)
+                          << std::setw(10) << referenceMs / ms << (match ? "yes" : "NO") << "\n";
+            }
+        }
+    }
+
+    // Equalization of a grayscale image
+    ImageReadResult image;
+    image.meta = ImageMetadata(size, size, 8);
+    image.buffer = makeSyntheticSamples(size, 1, false);
+    std::vector<uint8_t> output;
+
+    std::cout << "\n" << std::left << std::setw(28) << "equalization" << std::setw(12) << "ms"
+              << std::setw(12) << "MP/s" << "vs global\n";
+    double globalMs = bench::timeRuns([&] { return histogramEqualization(image); }, repetitions, output);
+    std::vector<std::pair<std::string, double>> rows = {{"global", globalMs}};
+    for (int tileSize : {32, 64, 128}) {
+        double ms = bench::timeRuns([&] { return applyCLAHE(image, tileSize, 2.0); }, repetitions, output);
+        rows.emplace_back("clahe tile=" + std::to_string(tileSize) + " clip=2", ms);
+    }
+
+    for (const auto& [name, ms] : rows) {
+        std::cout << std::left << std::fixed << std::setprecision(2)
+                  << std::setw(28) << name << std::setw(12) << ms
+                  << std::setw(12) << megapixels / (ms / 1000.0) << ms / globalMs << "x\n";
+    }
+
+    return allMatch ? EXIT_SUCCESS : EXIT_FAILURE;
+}
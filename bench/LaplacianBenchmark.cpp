@@ -0,0 +1,109 @@
+// Laplacian edge detection: one multi-sigma call, which shares a cascade of Gaussian levels, against one
+// call per sigma. The cascade blurs each level from the one below, so a level differs from a direct blur by
+// the 4 sigma cut of the kernels, and the weakest zero crossings may flip. Every padding policy is checked:
+// the multi-sigma maps must match the single-sigma ones on all but MAX_DIFFERING_SHARE of their edge pixels,
+// near the border (within 4 sigma of it) as well as inside.
+//
+// Usage: LaplacianBenchmark [imageSize=1024] [repetitions=3]
+
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+#include <algorithm>
+#include "ImageIO.h"
+#include "ImageEdgeDetection.h"
+#include "BenchUtils.h"
+
+namespace {
+
+constexpr double MAX_DIFFERING_SHARE = 0.005;
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int size = (argc > 1) ? std::atoi(argv[1]) : 1024;
+    int repetitions = (argc > 2) ? std::atoi(argv[2]) : 3;
+
+    if (size < 3 || repetitions <= 0) {
+        std::cerr << "Usage: LaplacianBenchmark [imageSize] [repetitions]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Smooth shapes plus noise, with edges at every scale the sigmas look at
+    ImageReadResult image = bench::makeSyntheticImage(size, [](int r, int c, std::mt19937& rng) {
+        bool inside = ((r / 97) + (c / 131)) % 2 == 0;
+        bool stripe = ((r + 2 * c) / 9) % 2 == 0;
+        return (inside ? 150 : 60) + (stripe ? 20 : 0) + static_cast<int>(rng() % 40);
+    });
+    ImageView view = makeGrayscaleView(image);
+    const std::vector<double> sigmas = {1.0, 1.6, 2.56, 4.0, 6.0};
+    const double slopeThreshold = 4.0;
+
+    const std::vector<std::pair<LaplacianMethod, const char*>> methods = {
+        {LaplacianMethod::LOG, "log"},
+        {LaplacianMethod::DOG, "dog"},
+    };
+    const std::vector<std::pair<PaddingChoice, const char*>> paddings = {
+        {PaddingChoice::ZERO, "zero"},
+        {PaddingChoice::REPLICATE, "replicate"},
+        {PaddingChoice::REFLECT, "reflect"},
+    };
+
+    std::cout << "Laplacian benchmark, " << size << "x" << size << ", " << sigmas.size()
+              << " sigmas, median of " << repetitions << " runs\n";
+    std::cout << std::left << std::setw(8) << "method" << std::setw(16) << "one call ms" << std::setw(16)
+              << "per sigma ms" << "speedup\n";
+    for (const auto& [method, name] : methods) {
+        double sharedMs = bench::timeRuns([&, method = method] {
+            applyLaplacianEdgeDetection(view, sigmas, slopeThreshold, method);
+        }, repetitions);
+        double separateMs = bench::timeRuns([&, method = method] {
+            for (double sigma : sigmas) {
+                applyLaplacianEdgeDetection(view, {sigma}, slopeThreshold, method);
+            }
+        }, repetitions);
+        std::cout << std::left << std::fixed << std::setprecision(2) << std::setw(8) << name << std::setw(16)
+                  << sharedMs << std::setw(16) << separateMs << separateMs / sharedMs << "\n";
+    }
+
+    std::cout << "\nmulti-sigma against single-sigma, pixels that differ (near the border / inside)\n";
+    bool allMatch = true;
+    for (const auto& [method, methodName] : methods) {
+        for (const auto& [padding, paddingName] : paddings) {
+            std::vector<std::vector<uint8_t>> shared =
+                applyLaplacianEdgeDetection(view, sigmas, slopeThreshold, method, padding);
+            std::cout << std::left << std::setw(8) << methodName << std::setw(12) << paddingName;
+
+            for (size_t s = 0; s < sigmas.size(); ++s) {
+                std::vector<uint8_t> single =
+                    applyLaplacianEdgeDetection(view, {sigmas[s]}, slopeThreshold, method, padding).front();
+
+                // The widest level a map reads: DoG also reads 1.6 sigma
+                int band = static_cast<int>(std::ceil(4.0 * sigmas[s] * (method == LaplacianMethod::DOG ? 1.6 : 1.0)));
+                size_t edges = 0;
+                size_t nearBorder = 0;
+                size_t inside = 0;
+                for (int r = 0; r < size; ++r) {
+                    for (int c = 0; c < size; ++c) {
+                        size_t i = static_cast<size_t>(r) * size + c;
+                        edges += (single[i] != 0) ? 1 : 0;
+                        if (shared[s][i] != single[i]) {
+                            bool border = std::min({r, c, size - 1 - r, size - 1 - c}) < band;
+                            ++(border ? nearBorder : inside);
+                        }
+                    }
+                }
+                allMatch = allMatch && (nearBorder + inside <= MAX_DIFFERING_SHARE * static_cast<double>(edges));
+                std::cout << std::setw(14) << (std::to_string(nearBorder) + " / " + std::to_string(inside));
+            }
+            std::cout << "\n";
+        }
+    }
+
+    std::cout << "multi-sigma matches single-sigma: " << (allMatch ? "yes" : "NO") << "\n";
+    return allMatch ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,51 @@
+// Compares the sorting (std::nth_element) median engine with the sliding-histogram engine.
+//
+// Usage: MedianBenchmark [imageSize=512] [repetitions=3]
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+#include "ImageIO.h"
+#include "ImageFilter.h"
+#include "BenchUtils.h"
+
+int main(int argc, char* argv[]) {
+    int size = (argc > 1) ? std::atoi(argv[1]) : 512;
+    int repetitions = (argc > 2) ? std::atoi(argv[2]) : 3;
+
+    if (size <= 0 || repetitions <= 0) {
+        std::cerr << "Usage: MedianBenchmark [imageSize] [repetitions]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    ImageReadResult image = bench::makeSyntheticImage(size);
+    double megapixels = static_cast<double>(size) * size / 1e6;
+
+    std::cout << "Median filter benchmark, " << size << "x" << size << ", median of " << repetitions << " runs\n";
+    std::cout << std::left << std::setw(8) << "kernel"
+              << std::setw(14) << "sorting ms" << std::setw(16) << "histogram ms"
+              << std::setw(12) << "speedup" << std::setw(14) << "hist MP/s" << "match\n";
+
+    bool allMatch = true;
+    for (int kernelSize : {3, 7, 15, 31}) {
+        std::vector<uint8_t> sortingOutput;
+        std::vector<uint8_t> histogramOutput;
+
+        double sortingMs = bench::timeRuns([&] { return applyMedianFilter(image, kernelSize, MedianEngine::SORTING); },
+                                           repetitions, sortingOutput);
+        double histogramMs = bench::timeRuns([&] { return applyMedianFilter(image, kernelSize, MedianEngine::HISTOGRAM); },
+                                             repetitions, histogramOutput);
+        bool match = (sortingOutput == histogramOutput);
+        allMatch = allMatch && match;
+
+        std::cout << std::left << std::fixed << std::setprecision(2)
+                  << std::setw(8) << kernelSize
+                  << std::setw(14) << sortingMs << std::setw(16) << histogramMs
+                  << std::setw(12) << sortingMs / histogramMs
+                  << std::setw(14) << megapixels / (histogramMs / 1000.0)
+                  << (match ? "yes" : "NO") << "\n";
+    }
+
+    return allMatch ? EXIT_SUCCESS : EXIT_FAILURE;
+}
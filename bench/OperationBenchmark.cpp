@@ -0,0 +1,475 @@
+// Benchmark and regression suite for the public operations, driven through the pipeline steps so every
+// operation is timed through the same entry point the batch driver uses. Each step runs on synthetic
+// images at several sizes and on the 8-bit grayscale images of TestImages, with warm-up runs and the
+// median and 95th percentile of the timed runs. Results are written as JSON, one result per line.
+//
+// A comparison against a stored baseline flags every result that got slower by more than the
+// threshold, either right after a run (--baseline) or between two saved files (--compare).
+//
+// Usage: OperationBenchmark [--sizes 512,2048,8192] [--repetitions 5] [--warmup 1] [--images <dir>]
+//                           [--filter <text>] [--threads <n>] [--output <file.json>]
+//                           [--baseline <file.json>] [--threshold 10]
+//        OperationBenchmark --compare <baseline.json> <current.json> [--threshold 10]
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "ImageIO.h"
+#include "ImagePipeline.h"
+#include "MappedImage.h"
+#include "ThreadPool.h"
+#include "BenchUtils.h"
+#include "Convolution3x3.h"
+
+#ifndef BENCH_TEST_IMAGES_DIR
+#define BENCH_TEST_IMAGES_DIR "TestImages"
+#endif
+
+namespace {
+
+struct BenchmarkOptions {
+    std::vector<int> sizes = {512, 2048, 8192};
+    int repetitions = 5;
+    int warmup = 1;
+    int threads = 0;
+    double threshold = 10.0;     // percent
+    std::string imageDirectory = BENCH_TEST_IMAGES_DIR;
+    std::string filter;
+    std::string outputPath;
+    std::string baselinePath;
+    std::vector<std::string> comparePaths;
+};
+
+struct Input {
+    std::string name;
+    ImageReadResult image;
+};
+
+struct BenchmarkResult {
+    std::string operation;
+    std::string input;
+    int width = 0;
+    int height = 0;
+    double medianMs = 0.0;
+    double p95Ms = 0.0;
+};
+
+// Steps that are timed, with the kernel sizes worth comparing. "match" is added when a reference image exists.
+const std::vector<std::string> BENCHMARK_STEPS = {
+    "negative", "log", "gamma:c=1,g=0.6", "equalize", "clahe:tile=64,clip=2.0",
+    "box:k=3", "box:k=15", "box:k=51",
+    "gaussian:k=5,s=1.0", "gaussian:k=15,s=3.0", "gaussian:k=31,s=6.0", "gaussian:k=97,s=16.0",
+    "gaussian:s=1.0,engine=recursive", "gaussian:s=6.0,engine=recursive", "gaussian:s=16.0,engine=recursive",
+    "median:k=3", "median:k=7", "median:k=15",
+    "highpass:kernel=1", "sharpen:kernel=1", "umhbf:k=1.0",
+    "binary:t=128", "otsu", "adaptive:method=mean,w=15", "adaptive:method=sauvola,w=31",
+    "erode:kc=3,kr=3", "erode:kc=15,kr=15", "dilate:kc=3,kr=3", "dilate:kc=15,kr=15",
+    "open:kc=5,kr=5", "close:kc=5,kr=5", "boundary:kc=3,kr=3", "fillholes:kc=3,kr=3",
+    "gradient:kernel=sobel", "gradient:kernel=sobel,t=100,norm=l1", "gradient:kernel=prewitt",
+    "canny:lo=20,hi=60,s=1.4,k=5",
+    "canny:s=1.4,smoothing=recursive",
+    "laplacian:s=1.0,t=4", "laplacian:s=4.0,t=4", "laplacian:method=dog,s=2.0,t=4",
+};
+
+void printUsage(std::ostream& out) {
+    out << "Usage: OperationBenchmark [options]\n"
+        << "       OperationBenchmark --compare <baseline.json> <current.json> [--threshold <percent>]\n"
+        << "\n"
+        << "Options:\n"
+        << "  --sizes <n,n,...>       Sizes of the square synthetic images (default: 512,2048,8192)\n"
+        << "  --repetitions <n>       Timed runs per result (default: 5)\n"
+        << "  --warmup <n>            Untimed runs before them (default: 1)\n"
+        << "  --images <dir>          8-bit grayscale BMPs to time as well (default: " << BENCH_TEST_IMAGES_DIR << ")\n"
+        << "  --filter <text>         Only steps whose specification contains the text\n"
+        << "  --threads <n>           Threads per operation (default: all cores)\n"
+        << "  --output <file>         Writes the JSON there instead of to standard output\n"
+        << "  --baseline <file>       Compares the results with a saved run\n"
+        << "  --threshold <percent>   Slowdown reported as a regression (default: 10)\n";
+}
+
+std::vector<int> parseSizes(const std::string& text) {
+    std::vector<int> sizes;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        int size = std::atoi(item.c_str());
+        if (size <= 0) {
+            throw std::invalid_argument("Invalid size '" + item + "' in --sizes");
+        }
+        sizes.push_back(size);
+    }
+    return sizes;
+}
+
+bool parseArguments(int argc, char* argv[], BenchmarkOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        bool hasValue = (i + 1 < argc);
+
+        if (argument == "--help" || argument == "-h") {
+            return false;
+        } else if (argument == "--sizes" && hasValue) {
+            options.sizes = parseSizes(argv[++i]);
+        } else if (argument == "--repetitions" && hasValue) {
+            options.repetitions = std::atoi(argv[++i]);
+        } else if (argument == "--warmup" && hasValue) {
+            options.warmup = std::atoi(argv[++i]);
+        } else if (argument == "--images" && hasValue) {
+            options.imageDirectory = argv[++i];
+        } else if (argument == "--filter" && hasValue) {
+            options.filter = argv[++i];
+        } else if (argument == "--threads" && hasValue) {
+            options.threads = std::atoi(argv[++i]);
+        } else if (argument == "--output" && hasValue) {
+            options.outputPath = argv[++i];
+        } else if (argument == "--baseline" && hasValue) {
+            options.baselinePath = argv[++i];
+        } else if (argument == "--threshold" && hasValue) {
+            options.threshold = std::atof(argv[++i]);
+        } else if (argument == "--compare" && i + 2 < argc) {
+            options.comparePaths = {argv[i + 1], argv[i + 2]};
+            i += 2;
+        } else {
+            throw std::invalid_argument("Unknown or incomplete option " + argument);
+        }
+    }
+
+    if (options.repetitions <= 0 || options.warmup < 0 || options.threads < 0 || options.threshold < 0) {
+        throw std::invalid_argument("--repetitions must be positive, --warmup, --threads and --threshold non-negative");
+    }
+    return true;
+}
+
+// Inputs ----
+
+// Smooth gradient, noise and a few filled discs, so thresholds, morphology and edges all have something to do
+ImageReadResult makeSyntheticImage(int size) {
+    int radius = std::max(size / 16, 2);
+    return bench::makeSyntheticImage(size, [size, radius](int r, int c, std::mt19937& rng) {
+        int cellRow = r % (size / 4 + 1) - size / 8;
+        int cellColumn = c % (size / 4 + 1) - size / 8;
+        bool inDisc = cellRow * cellRow + cellColumn * cellColumn < radius * radius;
+        return (inDisc ? 200 : (r + c) * 128 / (2 * size)) + static_cast<int>(rng() % 48);
+    });
+}
+
+// Every 8-bit grayscale BMP of the directory, sorted by name so runs line up; other files are skipped
+std::vector<Input> loadTestImages(const std::string& directory) {
+    std::vector<std::filesystem::path> paths;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+        if (entry.path().extension() == ".bmp") {
+            paths.push_back(entry.path());
+        }
+    }
+    std::sort(paths.begin(), paths.end());
+
+    std::vector<Input> inputs;
+    for (const auto& path : paths) {
+        try {
+            ImageReadResult image = mapImage(path.string()).toImageReadResult();
+            if (image.buffer && image.meta.bitDepth == 8) {
+                inputs.push_back({path.filename().string(), std::move(image)});
+            }
+        } catch (const std::exception&) {
+            // Not a readable BMP; nothing to time
+        }
+    }
+    return inputs;
+}
+
+// Timing ----
+
+// Nearest-rank percentile of sorted timings
+double percentile(const std::vector<double>& sorted, double fraction) {
+    size_t rank = static_cast<size_t>(std::ceil(fraction * sorted.size()));
+    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+// Every run starts from a fresh copy of the input, made outside the timed region
+BenchmarkResult timeStep(const std::string& name, const PipelineStep& step, const Input& input,
+                         const BenchmarkOptions& options) {
+    std::vector<double> timings;
+    for (int run = 0; run < options.warmup + options.repetitions; ++run) {
+        ImageReadResult working = input.image;
+        auto start = std::chrono::steady_clock::now();
+        applyPipelineStep(working, step);
+        auto end = std::chrono::steady_clock::now();
+        if (run >= options.warmup) {
+            timings.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+        }
+    }
+    std::sort(timings.begin(), timings.end());
+
+    BenchmarkResult result;
+    result.operation = name;
+    result.input = input.name;
+    result.width = input.image.meta.width;
+    result.height = input.image.meta.height;
+    result.medianMs = percentile(timings, 0.5);
+    result.p95Ms = percentile(timings, 0.95);
+    return result;
+}
+
+// JSON ----
+
+std::string jsonString(const std::string& text) {
+    std::string quoted = "\"";
+    for (char ch : text) {
+        if (ch == '"' || ch == '\\') {
+            quoted += '\\';
+        }
+        quoted += ch;
+    }
+    return quoted + "\"";
+}
+
+void writeJson(std::ostream& out, const std::vector<BenchmarkResult>& results, const BenchmarkOptions& options) {
+    out << "{\n"
+        << "  \"benchmark\": \"OperationBenchmark\",\n"
+        << "  \"repetitions\": " << options.repetitions << ",\n"
+        << "  \"warmup\": " << options.warmup << ",\n"
+        << "  \"threads\": " << getThreadCount() << ",\n"
+        << "  \"simd\": " << jsonString(simdLevelName(activeSimdLevel())) << ",\n"
+        << "  \"results\": [\n";
+
+    out << std::fixed << std::setprecision(3);
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchmarkResult& result = results[i];
+        double megapixels = static_cast<double>(result.width) * result.height / 1e6;
+        out << "    {\"operation\": " << jsonString(result.operation)
+            << ", \"input\": " << jsonString(result.input)
+            << ", \"width\": " << result.width << ", \"height\": " << result.height
+            << ", \"median_ms\": " << result.medianMs << ", \"p95_ms\": " << result.p95Ms
+            << ", \"megapixels_per_s\": ";
+        // A median below the timer resolution has no meaningful rate, and JSON has no inf
+        if (result.medianMs > 0.0) {
+            out << megapixels / (result.medianMs / 1000.0);
+        } else {
+            out << "null";
+        }
+        out << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+/**
+ * Reads the "results" array of a file written by writeJson. Only what writeJson produces is understood:
+ * flat objects whose values are strings or numbers.
+ */
+std::vector<BenchmarkResult> readJson(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::invalid_argument("Cannot open " + path);
+    }
+    std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    size_t position = text.find("\"results\"");
+    if (position == std::string::npos) {
+        throw std::invalid_argument(path + " has no \"results\" array!");
+    }
+
+    auto readString = [&](size_t& at) {
+        std::string value;
+        for (++at; at < text.size() && text[at] != '"'; ++at) {
+            if (text[at] == '\\' && at + 1 < text.size()) {
+                ++at;
+            }
+            value += text[at];
+        }
+        ++at;
+        return value;
+    };
+
+    std::vector<BenchmarkResult> results;
+    size_t arrayEnd = text.find(']', position);
+    while ((position = text.find('{', position)) != std::string::npos && position < arrayEnd) {
+        size_t objectEnd = text.find('}', position);
+        std::map<std::string, std::string> fields;
+        for (size_t at = text.find('"', position); at < objectEnd; at = text.find('"', at)) {
+            std::string key = readString(at);
+            at = text.find_first_not_of(" \t\n:", at);
+            std::string value;
+            if (text[at] == '"') {
+                value = readString(at);
+            } else {
+                size_t end = text.find_first_of(",}", at);
+                value = text.substr(at, end - at);
+                at = end;
+            }
+            fields[key] = value;
+        }
+
+        BenchmarkResult result;
+        result.operation = fields["operation"];
+        result.input = fields["input"];
+        result.width = std::atoi(fields["width"].c_str());
+        result.height = std::atoi(fields["height"].c_str());
+        result.medianMs = std::atof(fields["median_ms"].c_str());
+        result.p95Ms = std::atof(fields["p95_ms"].c_str());
+        results.push_back(result);
+
+        position = objectEnd;
+        arrayEnd = text.find(']', objectEnd);
+    }
+    return results;
+}
+
+// Comparison ----
+
+// Runs this short are mostly timer and cache noise; they are listed but never flagged
+constexpr double NOISE_FLOOR_MS = 0.05;
+
+std::string resultKey(const BenchmarkResult& result) {
+    return result.operation + " | " + result.input + " " + std::to_string(result.width) + "x" + std::to_string(result.height);
+}
+
+// Prints every result found in both runs; returns the number of regressions above the threshold
+int compareResults(const std::vector<BenchmarkResult>& baseline, const std::vector<BenchmarkResult>& current,
+                   double thresholdPercent, std::ostream& out) {
+    std::map<std::string, const BenchmarkResult*> baselineByKey;
+    for (const BenchmarkResult& result : baseline) {
+        baselineByKey[resultKey(result)] = &result;
+    }
+
+    out << std::left << std::setw(64) << "result" << std::setw(14) << "baseline ms"
+        << std::setw(14) << "current ms" << std::setw(12) << "change %" << "status\n";
+
+    int regressions = 0;
+    int compared = 0;
+    for (const BenchmarkResult& result : current) {
+        auto match = baselineByKey.find(resultKey(result));
+        // A zero or unreadable baseline (e.g. inf or nan from an older file) gives no ratio to judge
+        if (match == baselineByKey.end() || !std::isfinite(match->second->medianMs) || match->second->medianMs <= 0.0 ||
+            !std::isfinite(result.medianMs)) {
+            continue;
+        }
+
+        double change = (result.medianMs / match->second->medianMs - 1.0) * 100.0;
+        bool measurable = std::max(result.medianMs, match->second->medianMs) >= NOISE_FLOOR_MS;
+        bool regressed = measurable && change > thresholdPercent;
+        regressions += regressed ? 1 : 0;
+        ++compared;
+
+        out << std::left << std::fixed << std::setprecision(2)
+            << std::setw(64) << resultKey(result) << std::setw(14) << match->second->medianMs
+            << std::setw(14) << result.medianMs << std::setw(12) << std::showpos << change << std::noshowpos
+            << (regressed ? "REGRESSION" : measurable ? "ok" : "too fast to judge") << "\n";
+    }
+
+    out << "\n" << compared << " results compared, " << regressions << " slower by more than "
+        << thresholdPercent << "%\n";
+    return regressions;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    BenchmarkOptions options;
+    try {
+        if (!parseArguments(argc, argv, options)) {
+            printUsage(std::cerr);
+            return EXIT_FAILURE;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n\n";
+        printUsage(std::cerr);
+        return EXIT_FAILURE;
+    }
+
+    if (!options.comparePaths.empty()) {
+        try {
+            int regressions = compareResults(readJson(options.comparePaths[0]), readJson(options.comparePaths[1]),
+                                             options.threshold, std::cout);
+            return regressions == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    setThreadCount(options.threads);
+
+    // The library reports progress on std::cout/std::cerr; progress goes to the terminal through its own handle
+    std::ostream progress(std::cerr.rdbuf());
+    std::ostream json(std::cout.rdbuf());
+    std::cout.setstate(std::ios_base::failbit);
+    std::cerr.setstate(std::ios_base::failbit);
+
+    std::vector<Input> testImages = loadTestImages(options.imageDirectory);
+    std::vector<Input> inputs;
+    for (int size : options.sizes) {
+        inputs.push_back({"synthetic", makeSyntheticImage(size)});
+    }
+    for (Input& input : testImages) {
+        inputs.push_back(std::move(input));
+    }
+
+    // Result name and the step it times; the reference path is left out of the name so results line up across machines
+    std::vector<std::pair<std::string, std::string>> specifications;
+    for (const std::string& specification : BENCHMARK_STEPS) {
+        specifications.emplace_back(specification, specification);
+    }
+    std::string reference = (std::filesystem::path(options.imageDirectory) / "lena512.bmp").string();
+    if (std::filesystem::exists(reference)) {
+        specifications.emplace_back("match:ref=lena512.bmp", "match:ref=" + reference);
+    }
+
+    std::vector<BenchmarkResult> results;
+    for (const auto& [name, specification] : specifications) {
+        if (name.find(options.filter) == std::string::npos) {
+            continue;
+        }
+        PipelineStep step = parsePipelineStep(specification);
+
+        for (const Input& input : inputs) {
+            try {
+                results.push_back(timeStep(name, step, input, options));
+                const BenchmarkResult& result = results.back();
+                progress << std::left << std::fixed << std::setprecision(2) << std::setw(40) << name
+                         << std::setw(48) << (input.name + " " + std::to_string(result.width) + "x" + std::to_string(result.height))
+                         << "median " << std::setw(10) << result.medianMs << "p95 " << result.p95Ms << " ms\n";
+            } catch (const std::exception& e) {
+                progress << std::left << std::setw(40) << name << std::setw(48) << input.name
+                         << "skipped (" << e.what() << ")\n";
+            }
+        }
+    }
+
+    std::cout.clear();
+    std::cerr.clear();
+
+    if (options.outputPath.empty()) {
+        writeJson(json, results, options);
+    } else {
+        std::ofstream file(options.outputPath);
+        writeJson(file, results, options);
+        if (!file) {
+            std::cerr << "Cannot write " << options.outputPath << std::endl;
+            return EXIT_FAILURE;
+        }
+        progress << "\nResults written to " << options.outputPath << "\n";
+    }
+
+    if (!options.baselinePath.empty()) {
+        try {
+            progress << "\n";
+            int regressions = compareResults(readJson(options.baselinePath), results, options.threshold, progress);
+            return regressions == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,91 @@
+// Measures how the row-band scheduler scales from 1 to N threads for each parallel operation,
+// and checks that every thread count produces the same output as the single-threaded run.
+//
+// Usage: ParallelBenchmark [imageSize=2048] [maxThreads=hardware concurrency] [repetitions=3]
+
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ImageIO.h"
+#include "ImageFilter.h"
+#include "ImageMorphology.h"
+#include "ImageEdgeDetection.h"
+#include "ThreadPool.h"
+#include "BenchUtils.h"
+
+namespace {
+
+struct Operation {
+    std::string name;
+    std::function<std::vector<uint8_t>(const ImageReadResult&)> run;
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int size = (argc > 1) ? std::atoi(argv[1]) : 2048;
+    int maxThreads = (argc > 2) ? std::atoi(argv[2]) : static_cast<int>(std::thread::hardware_concurrency());
+    int repetitions = (argc > 3) ? std::atoi(argv[3]) : 3;
+
+    if (size <= 0 || maxThreads <= 0 || repetitions <= 0) {
+        std::cerr << "Usage: ParallelBenchmark [imageSize] [maxThreads] [repetitions]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::vector<Operation> operations = {
+        {"box 15",        [](const ImageReadResult& img) { return applyBoxFilter(img, 15); }},
+        {"gaussian 15",   [](const ImageReadResult& img) { return applyGaussianFilter(img, 15, 3.0); }},
+        {"median 15",     [](const ImageReadResult& img) { return applyMedianFilter(img, 15); }},
+        {"high-pass",     [](const ImageReadResult& img) { return applyHighPassFilter(img, 2); }},
+        {"sobel",         [](const ImageReadResult& img) {
+            return applyGradientEdgeDetection(img, KernelChoice::SOBEL, false, 0.0, PaddingChoice::REPLICATE); }},
+        {"erosion 15x15", [](const ImageReadResult& img) { return applyErosion(img, 15, 15); }},
+        {"dilation 15x15",[](const ImageReadResult& img) { return applyDilation(img, 15, 15); }},
+    };
+
+    // 1, 2, 4, ... and maxThreads itself
+    std::vector<int> threadCounts;
+    for (int threads = 1; threads < maxThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    ImageReadResult image = bench::makeSyntheticImage(size);
+
+    std::cout << "Parallel scaling benchmark, " << size << "x" << size << ", median of " << repetitions << " runs\n";
+    std::cout << std::left << std::setw(16) << "operation" << std::setw(10) << "threads"
+              << std::setw(12) << "ms" << std::setw(10) << "speedup" << std::setw(12) << "efficiency" << "match\n";
+
+    bool allMatch = true;
+    for (const Operation& operation : operations) {
+        std::vector<uint8_t> reference;
+        double serialMs = 0.0;
+
+        for (int threads : threadCounts) {
+            setThreadCount(threads);
+
+            std::vector<uint8_t> output;
+            double ms = bench::timeRuns([&] { return operation.run(image); }, repetitions, output);
+            if (threads == 1) {
+                reference = output;
+                serialMs = ms;
+            }
+            bool match = (output == reference);
+            allMatch = allMatch && match;
+
+            double speedup = serialMs / ms;
+            std::cout << std::left << std::fixed << std::setprecision(2)
+                      << std::setw(16) << operation.name << std::setw(10) << threads
+                      << std::setw(12) << ms << std::setw(10) << speedup
+                      << std::setw(12) << speedup / threads
+                      << (match ? "yes" : "NO") << "\n";
+        }
+    }
+
+    setThreadCount(0);
+    return allMatch ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,133 @@
+// Lookup-table point operations: the table lookup at every instruction-set level the CPU supports,
+// the log transform against the per-pixel log() loop it replaced, and a chain of point operations run
+// step by step against the same chain fused into one table. Outputs are checked against the reference.
+//
+// Usage: PointOperationBenchmark [imageSize=4096] [repetitions=5]
+
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "ImageIO.h"
+#include "ImagePipeline.h"
+#include "IntensityTransformations.h"
+#include "LookupTable.h"
+#include "Convolution3x3.h"
+#include "BenchUtils.h"
+
+namespace {
+
+struct Workload {
+    std::string name;
+    std::function<std::vector<uint8_t>(const ImageReadResult&)> run;
+};
+
+// The log transform as it was before the tables: one log() per pixel
+std::vector<uint8_t> perPixelLog(const ImageReadResult& image) {
+    std::vector<uint8_t> buffer = *image.buffer;
+    double c = 255.0 / std::log(1 + 255.0);
+    for (uint8_t& value : buffer) {
+        value = static_cast<uint8_t>(std::min(255.0, c * std::log(1 + value)));
+    }
+    return buffer;
+}
+
+// Runs every step as its own pipeline, i.e. one pass over the image per step
+std::vector<uint8_t> stepByStep(const ImageReadResult& image, const std::vector<PipelineStep>& steps) {
+    ImageReadResult working = image;
+    for (const PipelineStep& step : steps) {
+        applyPipelineStep(working, step);
+    }
+    return *working.buffer;
+}
+
+std::vector<uint8_t> fused(const ImageReadResult& image, const std::vector<PipelineStep>& steps) {
+    ImageReadResult working = image;
+    applyPipeline(working, steps);
+    return *working.buffer;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int size = (argc > 1) ? std::atoi(argv[1]) : 4096;
+    int repetitions = (argc > 2) ? std::atoi(argv[2]) : 5;
+
+    if (size <= 0 || repetitions <= 0) {
+        std::cerr << "Usage: PointOperationBenchmark [imageSize] [repetitions]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    ImageReadResult image = bench::makeSyntheticImage(size, [](int r, int c, std::mt19937& rng) {
+        return static_cast<uint8_t>((r + c) / 16 + rng() % 96);
+    });
+    double megapixels = static_cast<double>(size) * size / 1e6;
+    SimdLevel best = detectSimdLevel();
+
+    std::vector<PipelineStep> chain = {
+        parsePipelineStep("negative"),
+        parsePipelineStep("gamma:c=1,g=1.2"),
+        parsePipelineStep("equalize"),
+        parsePipelineStep("log"),
+        parsePipelineStep("binary:t=100"),
+    };
+
+    // Workloads that are timed at every ISA level, each with the reference its output must match
+    LookupTable gamma = gammaTable(1.0, 0.6);
+    std::vector<std::pair<Workload, Workload>> workloads = {
+        {{"table lookup", [&](const ImageReadResult& img) {
+              std::vector<uint8_t> output(img.buffer->size());
+              applyLookupTable(gamma, img.buffer->data(), output.data(), output.size());
+              return output; }},
+         {"indexed loop", [&](const ImageReadResult& img) {
+              std::vector<uint8_t> output(img.buffer->size());
+              for (size_t i = 0; i < output.size(); ++i) output[i] = gamma((*img.buffer)[i]);
+              return output; }}},
+        {{"log transform", [](const ImageReadResult& img) {
+              ImageReadResult working = img;
+              applyLogTransform(working.buffer->data(), working.meta, -1);
+              return *working.buffer; }},
+         {"per-pixel log()", perPixelLog}},
+        {{"5-step fused", [&](const ImageReadResult& img) { return fused(img, chain); }},
+         {"5-step unfused", [&](const ImageReadResult& img) { return stepByStep(img, chain); }}},
+    };
+
+    std::cout << "Point operation benchmark, " << size << "x" << size << ", median of " << repetitions
+              << " runs, CPU supports up to " << simdLevelName(best) << "\n";
+    std::cout << std::left << std::setw(20) << "workload" << std::setw(10) << "ISA"
+              << std::setw(12) << "ms" << std::setw(12) << "MP/s" << std::setw(10) << "speedup" << "match\n";
+
+    auto printRow = [&](const std::string& name, const char* isa, double ms, double baselineMs, bool match) {
+        std::cout << std::left << std::fixed << std::setprecision(2)
+                  << std::setw(20) << name << std::setw(10) << isa
+                  << std::setw(12) << ms << std::setw(12) << megapixels / (ms / 1000.0)
+                  << std::setw(10) << baselineMs / ms << (match ? "yes" : "NO") << "\n";
+    };
+
+    bool allMatch = true;
+    for (const auto& [workload, reference] : workloads) {
+        // The reference runs at scalar level and is the baseline of the speedup column
+        setSimdLevel(SimdLevel::SCALAR);
+        std::vector<uint8_t> expected;
+        double baselineMs = bench::timeRuns([&] { return reference.run(image); }, repetitions, expected);
+        printRow(reference.name, "-", baselineMs, baselineMs, true);
+
+        for (int level = 0; level <= static_cast<int>(best); ++level) {
+            setSimdLevel(static_cast<SimdLevel>(level));
+
+            std::vector<uint8_t> output;
+            double ms = bench::timeRuns([&] { return workload.run(image); }, repetitions, output);
+            bool match = (output == expected);
+            allMatch = allMatch && match;
+            printRow(workload.name, simdLevelName(activeSimdLevel()), ms, baselineMs, match);
+        }
+    }
+
+    setSimdLevel(best);
+    return allMatch ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,49 @@
+#ifndef CONVOLUTION_3X3_H
+#define CONVOLUTION_3X3_H
+
+#include <cstdint>
+
+/* Vectorized 3x3 integer convolution
+ *
+ * The high-pass, sharpening and gradient operators all use small integer 3x3 kernels on 8-bit pixels.
+ * This engine widens the pixels to int16 and accumulates weight * pixel for every non-zero tap,
+ * 8 (SSE4.1), 16 (AVX2) or 32 (AVX-512BW) output pixels at a time. The instruction set is picked at
+ * run time from what the CPU supports; every level produces exactly the same result as the scalar loop.
+ *
+ * The sum is kept in int16, so the kernel must satisfy sum(|weight|) * 255 <= 32767 (|weights| <= 128 total),
+ * which every kernel in this project does by a wide margin.
+ */
+
+enum class SimdLevel {
+    SCALAR = 0,
+    SSE41,
+    AVX2,
+    AVX512
+};
+
+// Highest level the CPU supports
+SimdLevel detectSimdLevel();
+
+// Level in use; defaults to detectSimdLevel()
+SimdLevel activeSimdLevel();
+
+// Forces a lower level (benchmarks, comparisons). Levels above detectSimdLevel() are clamped.
+void setSimdLevel(SimdLevel level);
+
+const char* simdLevelName(SimdLevel level);
+
+struct Kernel3x3 {
+    int taps[3][3];
+};
+
+/**
+ * Correlates one output row: output[j] = sum over a, b of taps[a][b] * rows[a][j + b], for j in [0, count).
+ * Each input row must hold count + 2 readable pixels, i.e. the caller passes the row pointers one pixel
+ * to the left of the first output pixel's window centre.
+ */
+void convolveRow3x3(const uint8_t* const rows[3], int count, const Kernel3x3& kernel, int16_t* output);
+
+// Same, clamped to 0..255
+void convolveRow3x3Saturate(const uint8_t* const rows[3], int count, const Kernel3x3& kernel, uint8_t* output);
+
+#endif // CONVOLUTION_3X3_H
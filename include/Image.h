@@ -0,0 +1,65 @@
+#ifndef IMAGE_H
+#define IMAGE_H
+
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include "ImageView.h"
+
+/**
+ * @brief Owning image of pixel type T with contiguous rows (stride == width * channels).
+ *
+ * The pixels live in a std::vector, so an 8-bit result can be handed back to the std::vector based
+ * API with release() without copying. view() and subview() hand out non-owning views for the filters;
+ * they stay valid as long as the Image is neither destroyed nor released.
+ */
+template <typename T>
+class Image {
+public:
+    Image() = default;
+
+    Image(int width, int height, int channels = 1, T value = T())
+        : width_(width), height_(height), channels_(channels),
+          pixels_(static_cast<size_t>(width) * height * channels, value) {}
+
+    // Takes over an existing buffer of width * height * channels elements
+    Image(std::vector<T> pixels, int width, int height, int channels = 1)
+        : width_(width), height_(height), channels_(channels), pixels_(std::move(pixels)) {
+        if (pixels_.size() != static_cast<size_t>(width) * height * channels) {
+            throw std::invalid_argument("Pixel buffer does not match the image size!");
+        }
+    }
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+    int channels() const { return channels_; }
+    bool empty() const { return pixels_.empty(); }
+
+    T* data() { return pixels_.data(); }
+    const T* data() const { return pixels_.data(); }
+
+    BasicImageView<T> view() { return makeImageView(pixels_.data(), width_, height_, channels_); }
+    BasicImageView<const T> view() const { return makeImageView(pixels_.data(), width_, height_, channels_); }
+
+    BasicImageView<T> subview(int x, int y, int subWidth, int subHeight) {
+        return view().subview(x, y, subWidth, subHeight);
+    }
+    BasicImageView<const T> subview(int x, int y, int subWidth, int subHeight) const {
+        return view().subview(x, y, subWidth, subHeight);
+    }
+
+    // Gives up the pixel buffer; the image is empty afterwards
+    std::vector<T> release() {
+        width_ = height_ = 0;
+        return std::exchange(pixels_, std::vector<T>());
+    }
+
+private:
+    int width_ = 0;
+    int height_ = 0;
+    int channels_ = 1;
+    std::vector<T> pixels_;
+};
+
+#endif // IMAGE_H
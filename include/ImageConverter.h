@@ -5,9 +5,59 @@
 #include <cstdint>      // To use uint8_t
 
 #include "ImageIO.h"    // To use ImageReadResult struct
+#include "ImageView.h"
+#include "PackedBinaryImage.h"
 
 // Grayscale to binary
 std::vector<uint8_t> applyGrayscaleToBinary(const ImageReadResult& inputImage, int threshold);
 
+// Otsu ----
 
-#endif
\ No newline at end of file
+/**
+ * Otsu's threshold of a 256-bin histogram: the t that maximizes the between-class variance of
+ * [0, t] and (t, 255], found in one O(256) sweep. Use it like the threshold of applyGrayscaleToBinary
+ * (foreground is v > t).
+ */
+int otsuThreshold(const std::vector<uint64_t>& histogram);
+
+// applyGrayscaleToBinary with Otsu's threshold of the image
+std::vector<uint8_t> applyOtsuThreshold(const ImageReadResult& inputImage);
+
+// Adaptive (local) thresholds ----
+
+enum class AdaptiveThresholdMethod {
+    MEAN,       // T = mean - offset
+    GAUSSIAN,   // T = Gaussian-weighted mean - offset
+    NIBLACK,    // T = mean + k * stddev - offset
+    SAUVOLA     // T = mean * (1 + k * (stddev / 128 - 1)) - offset
+};
+
+// k used when none is given (dark text on a light background)
+constexpr double DEFAULT_NIBLACK_K = -0.2;
+constexpr double DEFAULT_SAUVOLA_K = 0.5;
+
+/**
+ * Thresholds every pixel against statistics of the windowSize x windowSize window around it (clipped at the
+ * border, like applyBoxFilter): 255 where v > T, 0 elsewhere. Means and standard deviations come from
+ * integral images of the pixels and their squares, built one row at a time, so the cost per pixel does
+ * not depend on the window size and memory stays O(width). GAUSSIAN weights the mean with a Gaussian of
+ * the window size (the sigma OpenCV uses), computed by a separable float pass and not rounded. It is the
+ * one method whose cost grows with the window (O(windowSize) per pixel), and it keeps a float image of
+ * the means (4 bytes per pixel). Rows are thresholded in parallel.
+ *
+ * @param windowSize Odd window side, at least 3.
+ * @param k          Weight of the standard deviation (NIBLACK, SAUVOLA); ignored by MEAN and GAUSSIAN.
+ * @param offset     Subtracted from every threshold.
+ * @throws std::invalid_argument for an even or too small window, or a view that is not single-channel.
+ */
+void applyAdaptiveThreshold(const ImageView& input, const MutableImageView& output,
+                            AdaptiveThresholdMethod method, int windowSize, double k, double offset = 0.0);
+
+// Straight into a bit-packed mask, without an 8-bit intermediate image
+void applyAdaptiveThreshold(const ImageView& input, PackedBinaryImage& output,
+                            AdaptiveThresholdMethod method, int windowSize, double k, double offset = 0.0);
+
+std::vector<uint8_t> applyAdaptiveThreshold(const ImageReadResult& inputImage,
+                                            AdaptiveThresholdMethod method, int windowSize, double k, double offset = 0.0);
+
+#endif
@@ -5,6 +5,14 @@
 #include <cstdint>
 #include "ImageIO.h" 
 #include "ImageUtils.h"
+#include "ImageView.h"
+#include "ImageFilter.h"
+
+// Gradient magnitude: sqrt(Gx^2 + Gy^2), or the cheaper |Gx| + |Gy|
+enum class GradientNorm {
+    L2 = 0,
+    L1
+};
 
 /**
  * @brief Applies a gradient-based edge detection with optional thresholding & padding.
@@ -14,6 +22,7 @@
  * @param applyThreshold If true, we produce a binary edge map; false => gradient map.
  * @param thresholdValue The threshold used if applyThreshold=true.
  * @param paddingChoice  Which padding method to use (NONE, ZERO, REPLICATE, REFLECT).
+ * @param norm           How Gx and Gy are combined into a magnitude.
  * @return A std::vector<uint8_t> representing the resulting image (same width & height as input).
  */
 std::vector<uint8_t> applyGradientEdgeDetection(
@@ -21,18 +30,143 @@ std::vector<uint8_t> applyGradientEdgeDetection(
     KernelChoice kernelChoice,
     bool applyThreshold,
     double thresholdValue,
-    PaddingChoice paddingChoice
+    PaddingChoice paddingChoice,
+    GradientNorm norm = GradientNorm::L2
+);
+
+std::vector<uint8_t> applyGradientEdgeDetection(
+    const ImageView& input,
+    KernelChoice kernelChoice,
+    bool applyThreshold,
+    double thresholdValue,
+    PaddingChoice paddingChoice,
+    GradientNorm norm = GradientNorm::L2
+);
+
+// Same, writing into a caller-owned view of the input's size
+void applyGradientEdgeDetection(
+    const ImageView& input,
+    const MutableImageView& output,
+    KernelChoice kernelChoice,
+    bool applyThreshold,
+    double thresholdValue,
+    PaddingChoice paddingChoice,
+    GradientNorm norm = GradientNorm::L2
 );
 
+/**
+ * @brief Raw gradient magnitudes, one float per pixel. applyGradientEdgeDetection does not need them;
+ *        this is for callers that combine magnitudes across several calls (e.g. band processing).
+ */
+std::vector<float> computeGradientMagnitude(
+    const ImageView& input,
+    KernelChoice kernelChoice,
+    PaddingChoice paddingChoice,
+    GradientNorm norm = GradientNorm::L2
+);
+
+/**
+ * @brief Binary edge map: 255 where the magnitude is >= thresholdValue, 0 elsewhere.
+ */
+std::vector<uint8_t> thresholdGradientMagnitude(const std::vector<float>& gradientMagnitudes, double thresholdValue);
+
+/**
+ * @brief Maps magnitudes from [minVal, maxVal] to [0, 255]. Passing the global range lets an image that
+ *        is processed in pieces be scaled exactly like the whole image.
+ */
+std::vector<uint8_t> scaleGradientMagnitude(const std::vector<float>& gradientMagnitudes, float minVal, float maxVal);
+
+/* Canny edge detection
+ *
+ * STAGED runs every stage over the whole image: the Gaussian result is rounded to 8 bits, and magnitude,
+ * direction (atan2) and the suppressed magnitudes each get a full-size float buffer.
+ *
+ * FUSED streams every row range through all stages at once. The horizontal Gaussian rows, the float
+ * smoothed rows, the magnitudes and the direction sectors each live in small ring buffers. The only
+ * full-size buffer is the 8-bit output. Smoothing is never rounded, so the gradients see the exact
+ * Gaussian. The direction is quantized to 4 sectors by comparing |Gy| with tan(22.5 deg) * |Gx| and
+ * tan(67.5 deg) * |Gx|, plus the sign of Gx * Gy, instead of calling atan2. Magnitudes are compared
+ * squared, so no sqrt is taken either. Per pixel it moves a few bytes where STAGED moves about 40.
+ *
+ * TILED runs the FUSED stages on 512 x 512 tiles in parallel, each with the halo its stages read, and
+ * resolves hysteresis inside every tile. Only the weak components that reach a tile border are merged
+ * globally, through union-find over labels recorded on the tile borders. Working memory is one tile's
+ * buffers per thread, plus 4 bytes per tile-border pixel; meant for very large images. The output is
+ * identical to FUSED.
+ *
+ * All engines mark strong edges 255. A weak pixel (low <= magnitude < high) is kept when a chain of
+ * weak pixels (8-connected, any length) links it to a strong one, and dropped otherwise. The tracking
+ * takes linear time. STAGED and FUSED use a stack on one thread, and union-find over row bands on
+ * several, with the same result. The union-find needs 4 bytes per pixel.
+ *
+ * Smoothing picks the Gaussian (see GaussianEngine). RECURSIVE ignores kernelSize and costs the same at
+ * any sigma. It needs whole rows and columns, so FUSED and TILED smooth the whole image first into a float
+ * buffer (4 bytes per pixel) and stream the later stages from it.
+ */
+enum class CannyEngine {
+    STAGED = 0,
+    FUSED,
+    TILED
+};
+
 std::vector<uint8_t> applyCannyEdgeDetection(
     const ImageReadResult& inputImage,
     double lowThreshold,
     double highThreshold,
     double sigma,
     int kernelSize,
-    PaddingChoice paddingChoice
+    PaddingChoice paddingChoice,
+    CannyEngine engine = CannyEngine::STAGED,
+    GaussianEngine smoothing = GaussianEngine::SEPARABLE
+);
+
+// Same on a single-channel view, writing into a caller-owned view of the input's size (not the input itself)
+void applyCannyEdgeDetection(
+    const ImageView& input,
+    const MutableImageView& output,
+    double lowThreshold,
+    double highThreshold,
+    double sigma,
+    int kernelSize,
+    PaddingChoice paddingChoice,
+    CannyEngine engine = CannyEngine::STAGED,
+    GaussianEngine smoothing = GaussianEngine::SEPARABLE
 );
 
+/* Laplacian edge detection (Marr-Hildreth)
+ *
+ * Edges are the zero crossings of a Laplacian response: a pixel is marked 255 when two opposite neighbours
+ * (left/right, up/down or a diagonal pair) have responses of opposite sign that differ by at least
+ * slopeThreshold. LOG takes the 3x3 Laplacian of the image smoothed by a separable Gaussian of sigma. DOG
+ * approximates it by G(1.6 sigma) - G(sigma). Both responses are scale-normalized (about sigma^2 times
+ * the Laplacian), so a slope threshold means the same at every sigma. The one-pixel image border is never
+ * marked.
+ */
+enum class LaplacianMethod {
+    LOG = 0,
+    DOG
+};
 
+std::vector<uint8_t> applyLaplacianEdgeDetection(
+    const ImageReadResult& inputImage,
+    double sigma,
+    double slopeThreshold,
+    LaplacianMethod method = LaplacianMethod::LOG,
+    PaddingChoice paddingChoice = PaddingChoice::REPLICATE
+);
+
+/**
+ * @brief One edge map per sigma. The sigmas share one cascade of Gaussian levels. Each level is blurred
+ *        from the one below it, and a DoG series with ratio 1.6 reuses every level. Only the input is
+ *        padded, so the border is handled as in a single-sigma call under every policy. A map differs from
+ *        the single-sigma one only by the cut of the cascaded kernels, on about 0.1% of its edge pixels.
+ */
+std::vector<std::vector<uint8_t>> applyLaplacianEdgeDetection(
+    const ImageView& input,
+    const std::vector<double>& sigmas,
+    double slopeThreshold,
+    LaplacianMethod method = LaplacianMethod::LOG,
+    PaddingChoice paddingChoice = PaddingChoice::REPLICATE
+);
 
 #endif
\ No newline at end of file
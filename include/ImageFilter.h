@@ -2,6 +2,8 @@
 #define IMAGE_FILTER_H
 
 #include "ImageIO.h"
+#include "IntegralImage.h"
+#include "ImageView.h"
 #include <vector>
 #include <stdexcept>
 #include <cmath>
@@ -10,15 +12,72 @@
 // Apply Box Filter Function
 std::vector<uint8_t> applyBoxFilter(const ImageReadResult& inputImage, int kernelSize);
 
+// Apply Box Filter directly on a (possibly strided or memory-mapped) grayscale view
+std::vector<uint8_t> applyBoxFilter(const ImageView& input, int kernelSize);
+
+// Same, writing into a caller-owned view of the input's size (e.g. a region of a larger image)
+void applyBoxFilter(const ImageView& input, const MutableImageView& output, int kernelSize);
+
+// Apply Box Filter from a precomputed integral image (O(1) per pixel, reusable across kernel sizes)
+std::vector<uint8_t> applyBoxFilter(const IntegralImage& integralImage, int kernelSize);
+
+/* Gaussian filter engines
+ *
+ * SEPARABLE convolves with the sampled kernel, 2 * (kernelSize / 2) + 1 taps per pass, and renormalizes
+ * where the window leaves the image. RECURSIVE runs the Young-van Vliet third-order recursion: its cost
+ * does not depend on sigma (kernelSize is ignored), which pays off from sigma of about 2 on. It needs
+ * sigma >= 0.5 and extends the image by replicating its edge pixels.
+ *
+ * The recursion only approximates the Gaussian. Its 2-D impulse response is off the sampled kernel by at
+ * most about 7% of the peak at sigma 1, 4% at sigma 2 and 2% from sigma 5 on (RMS error below 0.25% of
+ * the peak throughout). On 8-bit images, away from the border, it stays within 1 grey level of SEPARABLE
+ * from sigma 1.4 on (2 at sigma 1, 7 at sigma 0.5). Near the border the engines differ more, since
+ * SEPARABLE renormalizes the clipped kernel instead of replicating pixels.
+ */
+enum class GaussianEngine {
+    SEPARABLE = 0,
+    RECURSIVE
+};
+
 // Apply Gaussian Filter Function
-std::vector<uint8_t> applyGaussianFilter(const ImageReadResult& inputImage, int kernelSize, double sigma);
+std::vector<uint8_t> applyGaussianFilter(const ImageReadResult& inputImage, int kernelSize, double sigma,
+                                         GaussianEngine engine = GaussianEngine::SEPARABLE);
+std::vector<uint8_t> applyGaussianFilter(const ImageView& input, int kernelSize, double sigma,
+                                         GaussianEngine engine = GaussianEngine::SEPARABLE);
+void applyGaussianFilter(const ImageView& input, const MutableImageView& output, int kernelSize, double sigma,
+                         GaussianEngine engine = GaussianEngine::SEPARABLE);
+
+// Recursive Gaussian of a grayscale view, kept in float (not rounded to 8 bits)
+void recursiveGaussianFilter(const ImageView& input, const BasicImageView<float>& output, double sigma);
+
+// Normalized 1-D Gaussian with 2 * halfKernel + 1 taps; the 2-D kernel is its outer product
+std::vector<float> createGaussianKernel1D(int halfKernel, double sigma);
+
+// Horizontal pass of the separable Gaussian, uint8 rows -> float rows, renormalized at the left/right borders
+void convolveRowsGaussian(const ImageView& input, const BasicImageView<float>& output, const std::vector<float>& kernel);
+
+// Vertical pass, float rows -> float rows (not rounded), renormalized at the top/bottom borders
+void convolveColumnsGaussian(const BasicImageView<const float>& input, const BasicImageView<float>& output,
+                             const std::vector<float>& kernel);
+
+// Median filter engines
+enum class MedianEngine {
+    SORTING = 0,    // std::nth_element over the window, O(k^2) per pixel
+    HISTOGRAM       // sliding column histograms (Perreault-Hebert), O(1) per pixel
+};
 
 // Apply Median Filter
-std::vector<uint8_t> applyMedianFilter(const ImageReadResult& inputImage, int kernelSize);
+std::vector<uint8_t> applyMedianFilter(const ImageReadResult& inputImage, int kernelSize, MedianEngine engine = MedianEngine::HISTOGRAM);
+std::vector<uint8_t> applyMedianFilter(const ImageView& input, int kernelSize, MedianEngine engine = MedianEngine::HISTOGRAM);
+void applyMedianFilter(const ImageView& input, const MutableImageView& output, int kernelSize, MedianEngine engine = MedianEngine::HISTOGRAM);
 
-// Apply Lowpass Filter using Box, Gaussian, and Median Filter
+// Apply Lowpass Filter using Box, Gaussian, and Median Filter (prompts for the parameters on std::cin)
 std::vector<uint8_t> lowPassFilter(const ImageReadResult &inputImage);
 
+// Prompt-free variant: kernelChoice 1 = Box, 2 = Gaussian, 3 = Median, 4 = recursive Gaussian (kernelSize
+// unused); sigma is only used by the Gaussians
+std::vector<uint8_t> lowPassFilter(const ImageReadResult &inputImage, int kernelChoice, int kernelSize, double sigma = 1.0);
+
 // High-pass filter with dynamic kernel selection
 std::vector<uint8_t> applyHighPassFilter(const ImageReadResult& inputImage, int kernelChoice);
 
@@ -28,4 +87,7 @@ std::vector<uint8_t> applyImageSharpening(const ImageReadResult& inputImage, int
 // Unsharp masking and highboost filtering
 std::vector<uint8_t> applyUMHBF(const ImageReadResult& inputImage, double k);
 
+// Prompt-free variant; the blur is chosen as in the prompt-free lowPassFilter
+std::vector<uint8_t> applyUMHBF(const ImageReadResult& inputImage, double k, int kernelChoice, int kernelSize, double sigma = 1.0);
+
 #endif // IMAGE_FILTERS_H
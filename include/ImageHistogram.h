@@ -4,18 +4,31 @@
 #include <vector>
 #include <string>
 #include <cstdint>
+#include <algorithm>
 #include "ImageIO.h"
+#include "ImageView.h"
+#include "LookupTable.h"
 
 constexpr int NUM_BINS_8BIT = 256;
 constexpr int NUM_BINS_16BIT = 65536;
 constexpr char DEFAULT_HISTOGRAM_FILE[] = "histogram_data.csv";
 
 
+/**
+ * One 256-bin histogram per channel of an 8-bit view, all channels counted in a single pass, in parallel
+ * over row ranges. Counts are 64-bit, so images with more than 2^31 samples do not overflow.
+ */
+std::vector<std::vector<uint64_t>> computeChannelHistograms(const ImageView &view);
+
+// 256-bin histogram of a single-channel 8-bit view
+std::vector<uint64_t> computeHistogram(const ImageView &view);
+
 // Function prototypes
-void calculateHistogram(const ImageReadResult &result, std::vector<int> &histogram, int channel = -1) ;
-void displayHistogram(const std::vector<int> &histogram, int bitDepth, bool isColor, char channelName) ;
-void saveHistogramToFile(const std::vector<int> &histogram, const std::string &fileName);
-void displayHistogramAsBarChart(const std::vector<int> &histogram) ;
+// channel selects one channel of a 24-bit image; -1 counts every sample (the image for grayscale)
+void calculateHistogram(const ImageReadResult &result, std::vector<uint64_t> &histogram, int channel = -1) ;
+void displayHistogram(const std::vector<uint64_t> &histogram, int bitDepth, bool isColor, char channelName) ;
+void saveHistogramToFile(const std::vector<uint64_t> &histogram, const std::string &fileName);
+void displayHistogramAsBarChart(const std::vector<uint64_t> &histogram) ;
 void grayscaleHistogram(const ImageReadResult &result) ;
 void rgbHistogram(const ImageReadResult &result);
 std::vector<uint8_t> histogramEqualization(const ImageReadResult &result);
@@ -28,4 +41,122 @@ std::vector<uint8_t> histogramEqualization(const ImageReadResult &result);
  */
 std::vector<uint8_t> histogramEqualization(const ImageReadResult &result);
 
+/**
+ * The equalization mapping of a 256-bin histogram as a lookup table, so it can be composed with other
+ * point operations.
+ */
+LookupTable equalizationTable(const std::vector<uint64_t> &histogram);
+
+/* Histogram specification (matching)
+ *
+ * Maps an image so that its histogram follows a reference histogram: every source level v goes to the
+ * smallest reference level z whose reference CDF reaches the source CDF at v. The reference CDF depends
+ * on the reference only, so a batch computes it once (cumulativeDistribution) and reuses it for every
+ * image; per image it costs one histogram, a merge of the two CDFs into a table, and one lookup pass.
+ */
+
+/**
+ * Reads a histogram written by saveHistogramToFile ("level, count" lines after a header). Levels that
+ * are not listed count 0. The histogram has 256 bins, or 65536 if a level above 255 appears.
+ *
+ * @throws std::invalid_argument if the file cannot be opened or a line is malformed.
+ */
+std::vector<uint64_t> loadHistogramFromFile(const std::string &fileName);
+
+// Reference histogram from a .csv file (see loadHistogramFromFile) or, for any other path, from an image
+std::vector<uint64_t> loadReferenceHistogram(const std::string &path);
+
+// Normalized cumulative distribution of a histogram; the last entry is 1
+std::vector<double> cumulativeDistribution(const std::vector<uint64_t> &histogram);
+
+/**
+ * Level mapping from a source histogram onto a reference CDF with the same number of bins (256 or 65536).
+ *
+ * @throws std::invalid_argument if the bin counts differ or the source histogram is empty.
+ */
+std::vector<uint16_t> specificationMapping(const std::vector<uint64_t> &sourceHistogram, const std::vector<double> &referenceCdf);
+
+// The 8-bit mapping as a lookup table, so it can be composed with other point operations
+LookupTable specificationTable(const std::vector<uint64_t> &sourceHistogram, const std::vector<double> &referenceCdf);
+
+/**
+ * Matches an 8-bit grayscale, 24-bit (all samples share one mapping) or 16-bit image to a reference CDF
+ * and returns the new buffer.
+ */
+std::vector<uint8_t> histogramSpecification(const ImageReadResult &result, const std::vector<double> &referenceCdf);
+
+/* Contrast-limited adaptive histogram equalization (CLAHE)
+ *
+ * The image is cut into square tiles of tileSize pixels (the last row and column of tiles may be smaller).
+ * Every tile gets its own equalization table, computed from its histogram after clipping each bin at
+ * clipLimit times the mean bin count and spreading the clipped counts over all bins, which bounds how
+ * much the table can stretch contrast (and amplify noise) in flat tiles. Each pixel is mapped through the
+ * tables of the four tiles whose centers surround it and the results are blended bilinearly, so there
+ * are no seams at tile borders. Pixels outside the outermost tile centers use the nearest tables only.
+ *
+ * Because tiles are a fixed size rather than a fixed count, the tile geometry of a row does not depend on
+ * the image height, and a band reader only needs three rows of tables at a time (see applyClaheInBands in
+ * ImageStream.h).
+ */
+
+/**
+ * Applies CLAHE to a single-channel 8-bit view. Tiles are equalized in parallel, then rows are mapped in
+ * parallel. Output must match the input size; it may be the input itself.
+ *
+ * @param tileSize  Side of the square tiles in pixels.
+ * @param clipLimit Clip level as a multiple of the mean bin count; 0 disables clipping (plain adaptive
+ *                  equalization).
+ * @throws std::invalid_argument for a non-positive tile size or a negative clip limit.
+ */
+void applyCLAHE(const ImageView &input, const MutableImageView &output, int tileSize = 64, double clipLimit = 2.0);
+
+// CLAHE of an 8-bit grayscale image, returned as a new buffer
+std::vector<uint8_t> applyCLAHE(const ImageReadResult &result, int tileSize = 64, double clipLimit = 2.0);
+
+/**
+ * Equalization tables of every tile of a view whose top edge is a tile border, row-major (tile column
+ * fastest), computed in parallel.
+ */
+std::vector<LookupTable> claheTileTables(const ImageView &view, int tileSize, double clipLimit);
+
+/**
+ * @brief Maps rows of an image of a given size through the tile tables of CLAHE.
+ *
+ * The bilinear weights of every column are computed once up front; mapRow then walks the row in segments
+ * that lie between the same pair of tile centers.
+ */
+class ClaheInterpolator {
+public:
+    ClaheInterpolator(int width, int height, int tileSize);
+
+    int tileColumns() const { return tileColumns_; }
+    int tileRows() const { return tileRows_; }
+
+    // The two tile rows that image row `row` is blended from (equal near the top and bottom edges)
+    int upperTileRow(int row) const;
+    int lowerTileRow(int row) const { return std::min(upperTileRow(row) + 1, tileRows_ - 1); }
+
+    /**
+     * Maps one image row. upperTables and lowerTables point at the tileColumns() tables of
+     * upperTileRow(row) and lowerTileRow(row). input and output may be the same row.
+     */
+    void mapRow(int row, const uint8_t *input, uint8_t *output,
+                const LookupTable *upperTables, const LookupTable *lowerTables) const;
+
+private:
+    struct Segment {
+        int begin;
+        int end;
+        int leftTile;
+        int rightTile;
+    };
+
+    int width_;
+    int tileSize_;
+    int tileColumns_;
+    int tileRows_;
+    std::vector<Segment> segments_;
+    std::vector<uint16_t> rightWeights_;   // per column, 0..256
+};
+
 #endif
\ No newline at end of file
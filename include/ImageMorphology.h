@@ -4,13 +4,41 @@
 #include <vector>
 #include <cstdint>
 #include "ImageIO.h"
+#include "ImageView.h"
+#include "PackedBinaryImage.h"
 
 // Function prototypes for morphological operations
 std::vector<uint8_t> applyErosion(const ImageReadResult& inputImage, int kernelColumns, int kernelRows);
 std::vector<uint8_t> applyDilation(const ImageReadResult& inputImage, int kernelColumns, int kernelRows);
+std::vector<uint8_t> applyErosion(const ImageView& input, int kernelColumns, int kernelRows);
+std::vector<uint8_t> applyDilation(const ImageView& input, int kernelColumns, int kernelRows);
 std::vector<uint8_t> applyOpening(const ImageReadResult& inputImage, int kernelColumns, int kernelRows);
 std::vector<uint8_t> applyClosing(const ImageReadResult& inputImage, int kernelColumns, int kernelRows);
+std::vector<uint8_t> applyOpening(const ImageView& input, int kernelColumns, int kernelRows);
+std::vector<uint8_t> applyClosing(const ImageView& input, int kernelColumns, int kernelRows);
+
+// Writing into a caller-owned view of the input's size
+void applyErosion(const ImageView& input, const MutableImageView& output, int kernelColumns, int kernelRows);
+void applyDilation(const ImageView& input, const MutableImageView& output, int kernelColumns, int kernelRows);
+void applyOpening(const ImageView& input, const MutableImageView& output, int kernelColumns, int kernelRows);
+void applyClosing(const ImageView& input, const MutableImageView& output, int kernelColumns, int kernelRows);
 std::vector<uint8_t> applyBoundaryExtraction(const ImageReadResult& inputImage, int kernelColumns, int kernelRows);
 std::vector<uint8_t> applyHoleFilling(const ImageReadResult& inputImage, const std::pair<int, int>& seedPoint, int kernelColumns, int kernelRows);
 
+// Hole filling grown from several seed points (row, column) at once
+std::vector<uint8_t> applyMultiSeedHoleFilling(const ImageReadResult& inputImage, const std::vector<std::pair<int, int>>& seedPoints, int kernelColumns, int kernelRows);
+
+// Fills every hole: background regions that cannot be reached from the image border
+std::vector<uint8_t> applyAutomaticHoleFilling(const ImageReadResult& inputImage, int kernelColumns, int kernelRows);
+
+// Bit-packed versions for binary images (64 pixels per word), same clipped-window semantics as above
+PackedBinaryImage applyErosion(const PackedBinaryImage& inputImage, int kernelColumns, int kernelRows);
+PackedBinaryImage applyDilation(const PackedBinaryImage& inputImage, int kernelColumns, int kernelRows);
+PackedBinaryImage applyOpening(const PackedBinaryImage& inputImage, int kernelColumns, int kernelRows);
+PackedBinaryImage applyClosing(const PackedBinaryImage& inputImage, int kernelColumns, int kernelRows);
+PackedBinaryImage applyBoundaryExtraction(const PackedBinaryImage& inputImage, int kernelColumns, int kernelRows);
+PackedBinaryImage applyHoleFilling(const PackedBinaryImage& inputImage, const std::pair<int, int>& seedPoint, int kernelColumns, int kernelRows);
+PackedBinaryImage applyMultiSeedHoleFilling(const PackedBinaryImage& inputImage, const std::vector<std::pair<int, int>>& seedPoints, int kernelColumns, int kernelRows);
+PackedBinaryImage applyAutomaticHoleFilling(const PackedBinaryImage& inputImage, int kernelColumns, int kernelRows);
+
 #endif // IMAGE_MORPHOLOGY_H
@@ -0,0 +1,47 @@
+#ifndef IMAGE_PIPELINE_H
+#define IMAGE_PIPELINE_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include "ImageIO.h"
+
+/* Non-interactive processing pipelines
+ *
+ * A pipeline is a list of steps written as "name:key=value,key=value", for example
+ * "gaussian:k=5,s=1.4" or "canny:lo=20,hi=60". Every step replaces the image buffer with its result,
+ * so "median:k=3" followed by "gradient:kernel=sobel,t=100" denoises and then detects edges.
+ * Steps are validated when they are parsed, so a typo fails before any file is touched, and parameters
+ * that were left out are filled in with their defaults.
+ *
+ * Consecutive point operations (negative, log, gamma, equalize, match, binary, otsu) are composed into one
+ * lookup table and applied in a single pass over the image. "match:ref=<image or .csv>" matches the
+ * histogram to a reference; the reference is loaded once per path and reused by later images.
+ */
+
+struct PipelineStep {
+    std::string operation;
+    std::map<std::string, std::string> parameters;
+
+    bool hasParameter(const std::string& key) const;
+    int intParameter(const std::string& key) const;
+    double doubleParameter(const std::string& key) const;
+    const std::string& stringParameter(const std::string& key) const;
+};
+
+/**
+ * Parses one step specification.
+ *
+ * @throws std::invalid_argument for an unknown operation, an unknown parameter or a malformed value.
+ */
+PipelineStep parsePipelineStep(const std::string& specification);
+
+// Runs one step on an 8-bit grayscale image, replacing its buffer
+void applyPipelineStep(ImageReadResult& image, const PipelineStep& step);
+
+void applyPipeline(ImageReadResult& image, const std::vector<PipelineStep>& steps);
+
+// One line per operation with its parameters and defaults, for --help output
+std::string describePipelineOperations();
+
+#endif // IMAGE_PIPELINE_H
@@ -0,0 +1,132 @@
+#ifndef IMAGE_STREAM_H
+#define IMAGE_STREAM_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <functional>
+#include <cstdint>
+#include "ImageIO.h"
+#include "ImageUtils.h"
+#include "ImageView.h"
+#include "ImageEdgeDetection.h"
+
+/* Streaming (row-band) BMP processing
+ *
+ * readImage/writeImage hold the whole image in memory and refuse anything above 10000 px or 10 MB.
+ * The classes below read and write a BMP a few rows at a time instead, and processImageInBands runs
+ * a neighborhood operation over horizontal bands with enough halo rows above and below each band
+ * that every output row sees exactly the same neighbourhood as in the whole-image version. Peak
+ * memory is O(width * (bandRows + 2 * haloRows)).
+ *
+ * Rows are handled in file order (bottom-up for a standard BMP), the same order readImage uses.
+ */
+
+/**
+ * @brief Sequential reader for the pixel rows of an 8- or 24-bit BMP file.
+ */
+class BmpBandReader {
+public:
+    // Opens the file and parses the header. Returns false (and logs) on failure.
+    bool open(const std::string& filePath);
+
+    const ImageMetadata& meta() const { return meta_; }
+    const std::vector<uint8_t>& colorTable() const { return colorTable_; }
+
+    int channels() const { return meta_.bitDepth / 8; }
+    int rowsRead() const { return rowsRead_; }
+
+    // Reads the next `count` rows into dst (unpadded, width * channels bytes per row)
+    bool readRows(uint8_t* dst, int count);
+
+private:
+    std::ifstream file_;
+    ImageMetadata meta_;
+    std::vector<uint8_t> colorTable_;
+    std::vector<uint8_t> rowBuffer_;    // one padded file row
+    int rowsRead_ = 0;
+};
+
+/**
+ * @brief Incremental counterpart of writeImage: writes the header up front, then rows as they come.
+ */
+class BmpBandWriter {
+public:
+    // Writes a BITMAPINFOHEADER and, for 8-bit images, the color table
+    bool open(const std::string& filePath, const ImageMetadata& meta, const std::vector<uint8_t>& colorTable);
+
+    // Appends `count` unpadded rows; row padding is added here
+    bool writeRows(const uint8_t* src, int count);
+
+    // Flushes and checks that every row was written
+    bool close();
+
+private:
+    std::ofstream file_;
+    ImageMetadata meta_;
+    int rowsWritten_ = 0;
+};
+
+/**
+ * @brief A neighborhood operation that can be run band by band.
+ *
+ * apply() gets a band of rows (including the halo) as a single-channel view and returns one output byte
+ * per pixel of that band; only the rows at least haloRows away from a cut are kept. Operations that need
+ * a global statistic first get a measuring pass: measure() sees every band together with the range of
+ * rows [coreBegin, coreEnd) that belongs to it, before apply() is called on any band.
+ */
+struct StreamingOperation {
+    int haloRows = 0;
+    std::function<std::vector<uint8_t>(const ImageView& band)> apply;
+    std::function<void(const ImageView& band, int coreBegin, int coreEnd)> measure;
+};
+
+StreamingOperation streamingBoxFilter(int kernelSize);
+StreamingOperation streamingGaussianFilter(int kernelSize, double sigma);
+StreamingOperation streamingMedianFilter(int kernelSize);
+StreamingOperation streamingErosion(int kernelColumns, int kernelRows);
+StreamingOperation streamingDilation(int kernelColumns, int kernelRows);
+StreamingOperation streamingOpening(int kernelColumns, int kernelRows);
+StreamingOperation streamingClosing(int kernelColumns, int kernelRows);
+
+// Thresholded gradient maps stream in one pass; normalized maps take a measuring pass for the global range
+StreamingOperation streamingGradientEdgeDetection(
+    KernelChoice kernelChoice,
+    bool applyThreshold,
+    double thresholdValue,
+    PaddingChoice paddingChoice,
+    GradientNorm norm = GradientNorm::L2
+);
+
+/**
+ * Runs an operation over an 8-bit grayscale BMP in bands and writes the result to outputPath.
+ *
+ * @param inputPath  Input BMP (8-bit grayscale, any size).
+ * @param outputPath Output BMP, same dimensions and color table.
+ * @param operation  The operation to run.
+ * @param bandRows   Output rows produced per band.
+ * @return true on success.
+ */
+bool processImageInBands(
+    const std::string& inputPath,
+    const std::string& outputPath,
+    const StreamingOperation& operation,
+    int bandRows = 256
+);
+
+/**
+ * CLAHE (see ImageHistogram.h) of an 8-bit grayscale BMP of any size, in one pass over the file.
+ * Rows are read one row of tiles ahead, so at most three rows of tiles (pixels and tables) are held at
+ * once, whatever the image height. The result is the same as applyCLAHE on the whole image.
+ *
+ * @return true on success.
+ * @throws std::invalid_argument for a non-positive tile size or a negative clip limit.
+ */
+bool applyClaheInBands(
+    const std::string& inputPath,
+    const std::string& outputPath,
+    int tileSize = 64,
+    double clipLimit = 2.0
+);
+
+#endif // IMAGE_STREAM_H
@@ -3,6 +3,9 @@
 
 #include <vector>
 #include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include "ImageView.h"
 
 // 1. Kernel choice enum
 enum class KernelChoice {
@@ -19,6 +22,87 @@ enum class PaddingChoice {
     REFLECT
 };
 
+// 3. Border policies
+//
+// A policy maps an index that lies outside [0, size) to one inside it, or to -1 for a constant 0.
+// Kernels take the policy as a template parameter and read out-of-range pixels on the fly instead of
+// padding the image first; only the pixels that actually fall outside pay for the remapping.
+
+struct ZeroBorder {
+    static int remap(int, int) { return -1; }
+};
+
+struct ReplicateBorder {
+    static int remap(int index, int size) { return (index < 0) ? 0 : size - 1; }
+};
+
+// Mirror including the edge pixel (-1 -> 0, size -> size - 1); periodic when the pad is wider than the image
+struct ReflectBorder {
+    static int remap(int index, int size) {
+        int period = 2 * size;
+        index %= period;
+        if (index < 0) index += period;
+        return (index < size) ? index : period - 1 - index;
+    }
+};
+
+template <typename Border>
+inline int borderIndex(int index, int size) {
+    return (index >= 0 && index < size) ? index : Border::remap(index, size);
+}
+
+// Pixel (r, c), with coordinates outside the image resolved by the policy
+template <typename Border>
+inline uint8_t borderPixel(const ImageView& image, int r, int c) {
+    int row = borderIndex<Border>(r, image.height);
+    int col = borderIndex<Border>(c, image.width);
+    return (row < 0 || col < 0) ? 0 : image.row(row)[col];
+}
+
+/**
+ * @brief Writes image row r (any integer; rows outside the image are resolved by the policy) with padSize
+ *        border pixels on each side, i.e. width + 2 * padSize bytes. The inside of the row is a plain copy.
+ */
+template <typename Border>
+void loadBorderedRow(const ImageView& image, int r, int padSize, uint8_t* destination) {
+    int cols = image.width;
+    int sourceRow = borderIndex<Border>(r, image.height);
+    if (sourceRow < 0) {
+        std::memset(destination, 0, static_cast<size_t>(cols) + 2 * padSize);
+        return;
+    }
+
+    const uint8_t* source = image.row(sourceRow);
+    std::memcpy(destination + padSize, source, cols);
+    for (int k = 1; k <= padSize; ++k) {
+        int left = borderIndex<Border>(-k, cols);
+        int right = borderIndex<Border>(cols - 1 + k, cols);
+        destination[padSize - k] = (left < 0) ? 0 : source[left];
+        destination[padSize + cols - 1 + k] = (right < 0) ? 0 : source[right];
+    }
+}
+
+/**
+ * @brief Calls function(Policy{}) with the border policy for paddingChoice, so a kernel written as a template
+ *        over the policy can be picked at run time. NONE reads out-of-range pixels as 0, like ZERO.
+ */
+template <typename Function>
+decltype(auto) withBorderPolicy(PaddingChoice paddingChoice, Function&& function) {
+    switch (paddingChoice) {
+        case PaddingChoice::NONE:
+        case PaddingChoice::ZERO:
+            return function(ZeroBorder{});
+        case PaddingChoice::REPLICATE:
+            return function(ReplicateBorder{});
+        case PaddingChoice::REFLECT:
+            return function(ReflectBorder{});
+        default:
+            throw std::runtime_error("Unsupported padding choice.");
+    }
+}
+
+// 4. Physical padding, for callers that need a padded buffer
+
 /**
  * @brief Creates a new image buffer with replicate padding.
  * 
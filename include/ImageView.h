@@ -0,0 +1,92 @@
+#ifndef IMAGE_VIEW_H
+#define IMAGE_VIEW_H
+
+#include <cstdint>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include "ImageIO.h"
+
+/**
+ * @brief Non-owning view of pixel rows of type T (uint8_t, uint16_t, float, ...).
+ *
+ * Rows are `stride` elements apart, so padded rows (BMP rows are padded to 4 bytes), memory-mapped
+ * files and rectangular regions of a larger image can all be addressed in place. Row 0 is the first
+ * row in memory, which for a BMP file is the first row stored in the file, the same order readImage
+ * produces. A view of `const T` is read-only; a view of T can be written through and converts to the
+ * read-only view implicitly.
+ */
+template <typename T>
+struct BasicImageView {
+    T* data = nullptr;               // First pixel of row 0
+    int width = 0;                   // Pixels per row
+    int height = 0;                  // Number of rows
+    std::ptrdiff_t stride = 0;       // Elements from one row to the next (bytes for 8-bit views)
+    int channels = 1;                // Elements per pixel
+
+    T* row(int r) const { return data + r * stride; }
+
+    bool isValid() const {
+        return data != nullptr && width > 0 && height > 0 && channels > 0 &&
+               stride >= static_cast<std::ptrdiff_t>(width) * channels;
+    }
+
+    /**
+     * @brief The width x height region whose top-left pixel is (x, y). Shares the pixels, so writing
+     *        through a subview of a writable view writes into this one.
+     */
+    BasicImageView subview(int x, int y, int subWidth, int subHeight) const {
+        if (x < 0 || y < 0 || subWidth <= 0 || subHeight <= 0 || x + subWidth > width || y + subHeight > height) {
+            throw std::out_of_range("Subview does not lie inside the image!");
+        }
+        BasicImageView region = *this;
+        region.data = row(y) + static_cast<std::ptrdiff_t>(x) * channels;
+        region.width = subWidth;
+        region.height = subHeight;
+        return region;
+    }
+
+    // Writable view -> read-only view
+    template <typename U = T, typename = std::enable_if_t<!std::is_const_v<U>>>
+    operator BasicImageView<const U>() const {
+        return BasicImageView<const U>{data, width, height, stride, channels};
+    }
+};
+
+// The 8-bit views every filter works on
+using ImageView = BasicImageView<const uint8_t>;
+using MutableImageView = BasicImageView<uint8_t>;
+
+/**
+ * @brief View over contiguous rows of width * channels elements, e.g. a std::vector the caller owns.
+ */
+template <typename T>
+BasicImageView<T> makeImageView(T* data, int width, int height, int channels = 1) {
+    return BasicImageView<T>{data, width, height, static_cast<std::ptrdiff_t>(width) * channels, channels};
+}
+
+/**
+ * @brief Grayscale view over an in-memory image buffer (rows of meta.width bytes, no padding).
+ *
+ * This is how the filters have always interpreted ImageReadResult::buffer.
+ */
+inline ImageView makeGrayscaleView(const ImageReadResult& image) {
+    ImageView view;
+    view.data = image.buffer ? image.buffer->data() : nullptr;
+    view.width = image.meta.width;
+    view.height = image.meta.height;
+    view.stride = image.meta.width;
+    view.channels = 1;
+    return view;
+}
+
+// Output views must match the input size; filters do not support writing over their own input
+template <typename T, typename U>
+void requireSameSize(const BasicImageView<T>& input, const BasicImageView<U>& output) {
+    if (!output.isValid() || output.width != input.width || output.height != input.height ||
+        output.channels != input.channels) {
+        throw std::invalid_argument("Output view must be valid and match the input size!");
+    }
+}
+
+#endif // IMAGE_VIEW_H
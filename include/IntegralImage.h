@@ -0,0 +1,62 @@
+#ifndef INTEGRAL_IMAGE_H
+#define INTEGRAL_IMAGE_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "ImageIO.h"
+
+/**
+ * @brief Summed-area table of an 8-bit grayscale image.
+ *
+ * Built once in O(width * height); afterwards the sum, pixel count and mean of any
+ * axis-aligned rectangle can be queried in O(1), independent of the rectangle size.
+ * Rectangles are clipped to the image, so windows that hang over the border only
+ * average the in-bounds pixels (the same semantics as applyBoxFilter).
+ *
+ * The table has (height + 1) x (width + 1) entries with a zero first row/column,
+ * which removes every special case from the queries.
+ */
+class IntegralImage {
+public:
+    IntegralImage() = default;
+
+    /**
+     * @param buffer  Grayscale pixels, row-major, width * height bytes.
+     * @param width   Image width.
+     * @param height  Image height.
+     */
+    IntegralImage(const uint8_t* buffer, int width, int height);
+
+    explicit IntegralImage(const ImageReadResult& inputImage);
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+
+    /**
+     * @brief Sum of the pixels in rows [top, bottom] and columns [left, right] (inclusive),
+     *        after clipping the rectangle to the image. Returns 0 for an empty rectangle.
+     */
+    uint64_t sum(int top, int left, int bottom, int right) const;
+
+    /**
+     * @brief Number of in-bounds pixels in the (clipped) rectangle.
+     */
+    int64_t count(int top, int left, int bottom, int right) const;
+
+    /**
+     * @brief Mean of the in-bounds pixels of the (2*halfKernel+1)^2 window centered at (row, col).
+     */
+    double localMean(int row, int col, int halfKernel) const;
+
+private:
+    int width_ = 0;
+    int height_ = 0;
+    std::vector<uint64_t> table_;   // (height_ + 1) x (width_ + 1)
+
+    uint64_t at(int row, int col) const {
+        return table_[static_cast<size_t>(row) * (width_ + 1) + col];
+    }
+};
+
+#endif // INTEGRAL_IMAGE_H
@@ -4,8 +4,15 @@
 #include <stdint.h> // For uint8_t
 #include "ImageIO.h"
 
+// All of these work in place on 8-bit grayscale or 24-bit buffers
 void applyNegative(uint8_t *buffer, const ImageMetadata &meta);
+
+// These two prompt for their parameters on std::cin
 void applyLogTransform(uint8_t *buffer, const ImageMetadata &meta);
 void applyGammaTransform(uint8_t *buffer, const ImageMetadata &meta);
 
+// Prompt-free variants; pass -1 for c or gamma to use the default value
+void applyLogTransform(uint8_t *buffer, const ImageMetadata &meta, double c);
+void applyGammaTransform(uint8_t *buffer, const ImageMetadata &meta, double c, double gamma);
+
 #endif // IMAGE_TRANSFORMS_H
@@ -0,0 +1,60 @@
+#ifndef LOOKUP_TABLE_H
+#define LOOKUP_TABLE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "ImageView.h"
+
+/* Point operations as lookup tables
+ *
+ * On 8-bit data every point operation (negative, log, gamma, thresholding, histogram equalization) is
+ * a function of the pixel value alone, so it is fully described by 256 output values. The table is
+ * computed once, 256 evaluations of log()/pow() instead of one per pixel, and a chain of point
+ * operations composes into a single table, so N steps cost one pass over the image instead of N.
+ *
+ * applyLookupTable picks the lookup instruction at run time (see Convolution3x3.h for the levels):
+ * SSE4.1 and AVX2 split the table into 16 blocks of 16 entries and select with pshufb on the low
+ * nibble, AVX-512 uses vpermi2b (two 128-entry halves) when the CPU has VBMI. Every level gives the
+ * same result as the scalar loop.
+ */
+
+struct LookupTable {
+    uint8_t values[256];
+
+    uint8_t operator()(uint8_t value) const { return values[value]; }
+
+    // This table followed by next: result(v) = next(this(v))
+    LookupTable then(const LookupTable& next) const;
+
+    static LookupTable identity();
+};
+
+// 255 - v
+LookupTable negativeTable();
+
+// c * log(1 + v), clamped to 0..255 and truncated. c = -1 uses the default 255 / log(256).
+LookupTable logTable(double c);
+
+// c * v^gamma, clamped to 0..255 and truncated. c = -1 uses 255 / log(256), gamma = -1 uses 0.1.
+LookupTable gammaTable(double c, double gamma);
+
+// 255 where v > threshold, 0 elsewhere
+LookupTable thresholdTable(int threshold);
+
+/**
+ * @brief Histogram of the image after table has been applied, computed from the histogram before it
+ *        (no pass over the pixels). Lets a histogram-dependent step sit in the middle of a fused chain.
+ */
+std::vector<uint64_t> remapHistogram(const std::vector<uint64_t>& histogram, const LookupTable& table);
+
+// output[i] = table(input[i]) for count bytes; input and output may be the same buffer
+void applyLookupTable(const LookupTable& table, const uint8_t* input, uint8_t* output, size_t count);
+
+/**
+ * @brief Applies the table to every channel of every pixel of the view, row by row in parallel.
+ *        Output must match the input size; it may be the input itself.
+ */
+void applyLookupTable(const LookupTable& table, const ImageView& input, const MutableImageView& output);
+
+#endif // LOOKUP_TABLE_H
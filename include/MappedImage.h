@@ -0,0 +1,67 @@
+#ifndef MAPPED_IMAGE_H
+#define MAPPED_IMAGE_H
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include "ImageIO.h"
+#include "ImageView.h"
+
+/**
+ * @brief A BMP file mapped read-only into memory.
+ *
+ * The pixels are never copied: view() points straight into the mapping, with the BMP row padding
+ * expressed through ImageView::stride. The mapping lives as long as the MappedImage, so views must
+ * not outlive it. Move-only.
+ */
+class MappedImage {
+public:
+    MappedImage() = default;
+    ~MappedImage();
+
+    MappedImage(MappedImage&& other) noexcept;
+    MappedImage& operator=(MappedImage&& other) noexcept;
+    MappedImage(const MappedImage&) = delete;
+    MappedImage& operator=(const MappedImage&) = delete;
+
+    bool isValid() const { return mapping_ != nullptr; }
+
+    const ImageMetadata& meta() const { return meta_; }
+
+    // Pixel rows in file order (bottom-up for a standard BMP, like readImage)
+    ImageView view() const { return view_; }
+
+    // First HEADER_SIZE bytes of the file
+    const uint8_t* header() const { return static_cast<const uint8_t*>(mapping_); }
+
+    // Color table (empty for 24-bit images)
+    const uint8_t* colorTable() const { return colorTable_; }
+    size_t colorTableSize() const { return colorTableSize_; }
+
+    /**
+     * @brief Copies the image into an ImageReadResult with the same unpadded row layout as readImage's buffer.
+     */
+    ImageReadResult toImageReadResult() const;
+
+    friend MappedImage mapImage(const std::string& filePath);
+
+private:
+    void release();
+
+    void* mapping_ = nullptr;
+    size_t mappingSize_ = 0;
+    ImageMetadata meta_;
+    ImageView view_;
+    const uint8_t* colorTable_ = nullptr;
+    size_t colorTableSize_ = 0;
+};
+
+/**
+ * Maps a BMP file read-only.
+ *
+ * @param filePath Path to the input image file.
+ * @return A MappedImage; isValid() is false if the file could not be opened, mapped or parsed.
+ */
+MappedImage mapImage(const std::string& filePath);
+
+#endif // MAPPED_IMAGE_H
@@ -0,0 +1,71 @@
+#ifndef PACKED_BINARY_IMAGE_H
+#define PACKED_BINARY_IMAGE_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "ImageIO.h"
+
+/**
+ * @brief Binary image stored as one bit per pixel, 64 pixels per uint64_t.
+ *
+ * Column c of row r is bit (c % 64) of word (c / 64) of that row, so shifting a word toward its
+ * high bits moves pixels to the right. Every row starts on a word boundary; the bits past the
+ * image width in the last word of a row are always kept at 0.
+ *
+ * Any non-zero byte counts as foreground when packing, and foreground unpacks to 255, so the
+ * 0/255 output of applyGrayscaleToBinary round-trips unchanged.
+ */
+class PackedBinaryImage {
+public:
+    PackedBinaryImage() = default;
+
+    // All-background image
+    PackedBinaryImage(int width, int height);
+
+    // Packs a row-major 8-bit buffer of width * height bytes
+    PackedBinaryImage(const uint8_t* buffer, int width, int height);
+
+    explicit PackedBinaryImage(const ImageReadResult& inputImage);
+
+    // Packs one row of width() bytes over row r (non-zero = foreground)
+    void packRow(int r, const uint8_t* pixels);
+
+    // Unpacks to a row-major 0/255 buffer
+    std::vector<uint8_t> toBuffer() const;
+    void toBuffer(uint8_t* output) const;
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+    int wordsPerRow() const { return wordsPerRow_; }
+
+    uint64_t* row(int r) { return words_.data() + static_cast<size_t>(r) * wordsPerRow_; }
+    const uint64_t* row(int r) const { return words_.data() + static_cast<size_t>(r) * wordsPerRow_; }
+
+    bool get(int r, int c) const { return (row(r)[c >> 6] >> (c & 63)) & 1u; }
+    void set(int r, int c, bool value) {
+        uint64_t bit = uint64_t(1) << (c & 63);
+        if (value) row(r)[c >> 6] |= bit; else row(r)[c >> 6] &= ~bit;
+    }
+
+    // Valid-bit mask for the last word of each row
+    uint64_t lastWordMask() const {
+        int tailBits = width_ & 63;
+        return tailBits == 0 ? ~uint64_t(0) : (uint64_t(1) << tailBits) - 1;
+    }
+
+    size_t countForeground() const;
+
+    bool operator==(const PackedBinaryImage& other) const {
+        return width_ == other.width_ && height_ == other.height_ && words_ == other.words_;
+    }
+    bool operator!=(const PackedBinaryImage& other) const { return !(*this == other); }
+
+private:
+    int width_ = 0;
+    int height_ = 0;
+    int wordsPerRow_ = 0;
+    std::vector<uint64_t> words_;
+};
+
+#endif // PACKED_BINARY_IMAGE_H
@@ -0,0 +1,145 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "ImageView.h"
+
+/**
+ * @brief Fixed-size work-stealing thread pool.
+ *
+ * Every worker owns a task deque. It pops its own tasks from the back and, when that runs dry, steals
+ * from the front of the other deques, so a worker that drew cheap bands keeps busy with the leftovers of
+ * a worker that drew expensive ones. The thread calling parallelFor() works through the tasks as well
+ * and only blocks once nothing is left to steal.
+ */
+class ThreadPool {
+public:
+    // threadCount includes the calling thread; 0 means std::thread::hardware_concurrency()
+    explicit ThreadPool(int threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int threadCount() const { return static_cast<int>(workers_.size()) + 1; }
+
+    /**
+     * Runs task(0) ... task(taskCount - 1) and returns once all of them have finished.
+     * The first exception thrown by a task is rethrown here.
+     */
+    void parallelFor(int taskCount, const std::function<void(int)>& task);
+
+private:
+    struct Batch;
+    struct Task {
+        Batch* batch;
+        int index;
+    };
+    struct TaskQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    bool popOwn(int queueIndex, Task& task);
+    bool steal(int thiefIndex, Task& task);
+    void run(const Task& task);
+    void workerLoop(int queueIndex);
+
+    std::vector<std::thread> workers_;
+    std::vector<std::unique_ptr<TaskQueue>> queues_;   // one per worker
+
+    std::mutex sleepMutex_;
+    std::condition_variable wakeUp_;
+    std::atomic<int> queuedTasks_{0};
+    bool stopping_ = false;
+};
+
+// Pool shared by all image operations
+ThreadPool& sharedThreadPool();
+
+// Resizes the shared pool (0 = hardware concurrency). Call it while no operation is running.
+void setThreadCount(int threadCount);
+int getThreadCount();
+
+/**
+ * @brief Splits the rows [0, rows) into contiguous ranges of at least minimumRows rows and runs
+ *        rangeFunction(begin, end) on them in parallel.
+ *
+ * For operations that read the whole image directly and write disjoint output rows, so no halo is needed.
+ */
+template <typename RangeFunction>
+void parallelRowRanges(int rows, int minimumRows, RangeFunction&& rangeFunction) {
+    ThreadPool& pool = sharedThreadPool();
+
+    // Several ranges per thread so stealing can even out uneven ones
+    int rangeRows = std::max(std::max(1, minimumRows), (rows + 4 * pool.threadCount() - 1) / (4 * pool.threadCount()));
+    int rangeCount = (rows + rangeRows - 1) / rangeRows;
+
+    if (pool.threadCount() == 1 || rangeCount <= 1) {
+        rangeFunction(0, rows);
+        return;
+    }
+
+    pool.parallelFor(rangeCount, [&](int range) {
+        rangeFunction(range * rangeRows, std::min(rows, (range + 1) * rangeRows));
+    });
+}
+
+/**
+ * @brief Runs a neighborhood operation over horizontal bands of the image in parallel.
+ *
+ * Each band is handed to bandFunction(window, windowOutput) as a view of its rows plus haloRows extra
+ * rows above and below (clipped to the image), so the band sees exactly the neighbourhood the whole
+ * image would give it. bandFunction writes one value per pixel of the window into windowOutput; only
+ * the band's own rows end up in output. As long as haloRows covers the vertical reach of the operation,
+ * the result does not depend on the number of threads or on the band size and is identical to
+ * bandFunction(input, output), which is also what runs when there is only one band.
+ */
+template <typename T, typename BandFunction>
+void parallelRowBands(const ImageView& input, const BasicImageView<T>& output, int haloRows,
+                      BandFunction&& bandFunction) {
+    ThreadPool& pool = sharedThreadPool();
+    const int rows = input.height;
+    const int cols = input.width;
+
+    // Several bands per thread so stealing can even out uneven bands; halo rows are computed twice,
+    // so a band is never much thinner than its halo
+    int minimumBandRows = std::max(16, 4 * haloRows);
+    int bandRows = std::max(minimumBandRows, (rows + 4 * pool.threadCount() - 1) / (4 * pool.threadCount()));
+    int bandCount = (rows + bandRows - 1) / bandRows;
+
+    if (pool.threadCount() == 1 || bandCount <= 1) {
+        bandFunction(input, output);
+        return;
+    }
+
+    pool.parallelFor(bandCount, [&](int band) {
+        int coreBegin = band * bandRows;
+        int coreEnd = std::min(rows, coreBegin + bandRows);
+        int windowBegin = std::max(0, coreBegin - haloRows);
+        int windowEnd = std::min(rows, coreEnd + haloRows);
+
+        ImageView window = input;
+        window.data = input.row(windowBegin);
+        window.height = windowEnd - windowBegin;
+
+        // The halo rows of the output belong to the neighbouring bands, so the band writes to scratch
+        std::vector<std::remove_const_t<T>> scratch(static_cast<size_t>(window.height) * cols);
+        bandFunction(window, makeImageView(scratch.data(), cols, window.height));
+        for (int r = coreBegin; r < coreEnd; ++r) {
+            std::memcpy(output.row(r), scratch.data() + static_cast<size_t>(r - windowBegin) * cols, cols * sizeof(T));
+        }
+    });
+}
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,223 @@
+// Non-interactive batch driver: runs a pipeline of operations over many images.
+//
+// Usage: ImageBatch --op <step> [--op <step> ...] [options] <file or glob> ...
+//   e.g. ImageBatch --op gaussian:k=5,s=1.4 --op canny:lo=20,hi=60 --jobs 4 "../TestImages/*.bmp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <glob.h>
+#include "ImageIO.h"
+#include "ImagePipeline.h"
+#include "ImageStream.h"
+#include "MappedImage.h"
+#include "ThreadPool.h"
+
+namespace {
+
+struct BatchOptions {
+    std::vector<PipelineStep> steps;
+    std::vector<std::string> inputs;
+    std::string outputDirectory = "output";
+    int jobs = 1;
+    int threads = 0;
+    bool verbose = false;
+};
+
+struct FileResult {
+    bool ok = false;
+    double milliseconds = 0.0;
+    double megabytes = 0.0;      // pixel data processed
+    std::string error;
+};
+
+void printUsage(std::ostream& out) {
+    out << "Usage: ImageBatch --op <step> [--op <step> ...] [options] <file or glob> ...\n"
+        << "\n"
+        << "Options:\n"
+        << "  --op <name[:key=value,...]>  Pipeline step, applied in the order given\n"
+        << "  --output-dir <dir>           Where results are written (default: output)\n"
+        << "  --jobs <n>                   Files processed concurrently (default: 1)\n"
+        << "  --threads <n>                Threads per operation, shared by all jobs (default: all cores)\n"
+        << "  --verbose                    Keep the library's progress messages\n"
+        << "\n"
+        << "Operations (defaults shown):\n"
+        << describePipelineOperations();
+}
+
+// Expands shell-style patterns that the shell did not expand (e.g. quoted ones); plain paths pass through
+std::vector<std::string> expandInputs(const std::vector<std::string>& patterns) {
+    std::vector<std::string> files;
+    for (const std::string& pattern : patterns) {
+        if (pattern.find_first_of("*?[") == std::string::npos) {
+            files.push_back(pattern);
+            continue;
+        }
+
+        glob_t matches;
+        if (glob(pattern.c_str(), 0, nullptr, &matches) == 0) {
+            for (size_t i = 0; i < matches.gl_pathc; ++i) {
+                files.emplace_back(matches.gl_pathv[i]);
+            }
+        }
+        globfree(&matches);
+    }
+    return files;
+}
+
+bool parseArguments(int argc, char* argv[], BatchOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        bool hasValue = (i + 1 < argc);
+
+        if (argument == "--help" || argument == "-h") {
+            return false;
+        } else if (argument == "--op" && hasValue) {
+            options.steps.push_back(parsePipelineStep(argv[++i]));
+        } else if (argument == "--output-dir" && hasValue) {
+            options.outputDirectory = argv[++i];
+        } else if (argument == "--jobs" && hasValue) {
+            options.jobs = std::atoi(argv[++i]);
+        } else if (argument == "--threads" && hasValue) {
+            options.threads = std::atoi(argv[++i]);
+        } else if (argument == "--verbose") {
+            options.verbose = true;
+        } else if (argument.rfind("--", 0) == 0) {
+            throw std::invalid_argument("Unknown or incomplete option " + argument);
+        } else {
+            options.inputs.push_back(argument);
+        }
+    }
+
+    if (options.jobs <= 0 || options.threads < 0) {
+        throw std::invalid_argument("--jobs must be positive and --threads non-negative");
+    }
+    return !options.steps.empty() && !options.inputs.empty();
+}
+
+FileResult processFile(const std::string& inputPath, const BatchOptions& options) {
+    FileResult result;
+    auto start = std::chrono::steady_clock::now();
+
+    try {
+        // mapImage has none of readImage's size limits and handles padded rows
+        ImageReadResult image = mapImage(inputPath).toImageReadResult();
+        if (!image.buffer) {
+            result.error = "could not read image";
+            return result;
+        }
+        result.megabytes = static_cast<double>(image.buffer->size()) / (1024.0 * 1024.0);
+
+        applyPipeline(image, options.steps);
+
+        std::string outputPath = (std::filesystem::path(options.outputDirectory) /
+                                  std::filesystem::path(inputPath).filename()).string();
+        BmpBandWriter writer;
+        if (!writer.open(outputPath, image.meta, image.colorTable) ||
+            !writer.writeRows(image.buffer->data(), image.meta.height) ||
+            !writer.close()) {
+            result.error = "could not write " + outputPath;
+            return result;
+        }
+        result.ok = true;
+    } catch (const std::exception& e) {
+        result.error = e.what();
+    }
+
+    result.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    BatchOptions options;
+    try {
+        if (!parseArguments(argc, argv, options)) {
+            printUsage(std::cerr);
+            return EXIT_FAILURE;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n\n";
+        printUsage(std::cerr);
+        return EXIT_FAILURE;
+    }
+
+    std::vector<std::string> files = expandInputs(options.inputs);
+    if (files.empty()) {
+        std::cerr << "No input files matched." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::error_code directoryError;
+    std::filesystem::create_directories(options.outputDirectory, directoryError);
+    if (directoryError) {
+        std::cerr << "Cannot create " << options.outputDirectory << ": " << directoryError.message() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    setThreadCount(options.threads);
+
+    // The library reports progress on std::cout/std::cerr; the report keeps its own handle on the terminal
+    std::ostream report(std::cout.rdbuf());
+    if (!options.verbose) {
+        std::cout.setstate(std::ios_base::failbit);
+        std::cerr.setstate(std::ios_base::failbit);
+    }
+
+    std::vector<FileResult> results(files.size());
+    std::atomic<size_t> nextFile{0};
+    std::mutex reportMutex;
+
+    report << std::left << std::setw(12) << "ms" << std::setw(12) << "MB/s" << std::setw(8) << "status" << "file\n";
+
+    auto worker = [&]() {
+        for (size_t index = nextFile++; index < files.size(); index = nextFile++) {
+            results[index] = processFile(files[index], options);
+
+            const FileResult& result = results[index];
+            std::lock_guard<std::mutex> lock(reportMutex);
+            report << std::left << std::fixed << std::setprecision(2)
+                   << std::setw(12) << result.milliseconds
+                   << std::setw(12) << (result.ok ? result.megabytes / (result.milliseconds / 1000.0) : 0.0)
+                   << std::setw(8) << (result.ok ? "ok" : "FAILED") << files[index]
+                   << (result.ok ? "" : " (" + result.error + ")") << "\n";
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int i = 1; i < std::min<int>(options.jobs, static_cast<int>(files.size())); ++i) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : workers) {
+        thread.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout.clear();
+    std::cerr.clear();
+
+    size_t succeeded = 0;
+    double megabytes = 0.0;
+    for (const FileResult& result : results) {
+        if (result.ok) {
+            ++succeeded;
+            megabytes += result.megabytes;
+        }
+    }
+
+    report << "\n" << succeeded << "/" << files.size() << " images in " << std::setprecision(3) << seconds << " s: "
+           << succeeded / seconds << " images/s, " << megabytes / seconds << " MB/s"
+           << " (jobs=" << options.jobs << ", threads=" << getThreadCount() << ")\n";
+
+    return succeeded == files.size() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
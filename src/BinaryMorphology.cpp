@@ -0,0 +1,397 @@
+#include "ImageMorphology.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+/* Morphology on PackedBinaryImage (64 pixels per uint64_t)
+ *
+ * Same rectangular structuring element and clipped-window semantics as the byte versions, expressed as
+ * AND (erosion) / OR (dilation) over bit rows:
+ *  - Row pass: a trailing window op of width w is built by doubling (C_2s = C_s op (C_s shifted by s)),
+ *    so it costs O(log w) multi-word shifts per row. The row is extended by half a window of identity
+ *    bits so the centered window can be read back with one more shift.
+ *  - Column pass: van Herk/Gil-Werman over whole word rows, 3 word ops per 64 pixels.
+ * Out-of-bounds positions are filled with the identity (1 for AND, 0 for OR), which is what the
+ * clipped window does.
+ *
+ * Hole filling is a morphological reconstruction: forward and backward row sweeps propagate the filled
+ * region from the rows above/below (within the structuring element), and inside a row the region is
+ * grown along runs of background with a carry-propagating Kogge-Stone fill. Sweeps repeat until
+ * nothing changes; each sweep touches every word a constant number of times.
+ */
+
+namespace {
+
+struct WordAnd {
+    static constexpr uint64_t identity = ~uint64_t(0);
+    static uint64_t apply(uint64_t a, uint64_t b) { return a & b; }
+};
+
+struct WordOr {
+    static constexpr uint64_t identity = 0;
+    static uint64_t apply(uint64_t a, uint64_t b) { return a | b; }
+};
+
+// dst[j] = src[j - d]: pixels move toward higher columns, vacated positions get fill
+void shiftTowardHigher(const uint64_t* src, uint64_t* dst, int words, int d, uint64_t fill) {
+    int wordShift = d >> 6;
+    int bitShift = d & 63;
+
+    for (int k = words - 1; k >= 0; --k) {
+        int source = k - wordShift;
+        uint64_t current = (source >= 0) ? src[source] : fill;
+        if (bitShift == 0) {
+            dst[k] = current;
+        } else {
+            uint64_t lower = (source - 1 >= 0) ? src[source - 1] : fill;
+            dst[k] = (current << bitShift) | (lower >> (64 - bitShift));
+        }
+    }
+}
+
+// dst[j] = src[j + d]: pixels move toward lower columns, vacated positions get fill
+void shiftTowardLower(const uint64_t* src, uint64_t* dst, int words, int d, uint64_t fill) {
+    int wordShift = d >> 6;
+    int bitShift = d & 63;
+
+    for (int k = 0; k < words; ++k) {
+        int source = k + wordShift;
+        uint64_t current = (source < words) ? src[source] : fill;
+        if (bitShift == 0) {
+            dst[k] = current;
+        } else {
+            uint64_t higher = (source + 1 < words) ? src[source + 1] : fill;
+            dst[k] = (current >> bitShift) | (higher << (64 - bitShift));
+        }
+    }
+}
+
+// Scratch rows for the row pass, sized for a row extended by `half` identity bits
+struct RowScratch {
+    int words = 0;
+    std::vector<uint64_t> extended, window, shifted;
+
+    RowScratch(int width, int half)
+        : words((width + half + 63) / 64 + 1), extended(words), window(words), shifted(words) {}
+};
+
+// dst[j] = op over src[j - half .. j + half], clipped to the row. dst gets wordsPerRow words with
+// the bits past the width cleared.
+template <typename Op>
+void windowRow(const uint64_t* src, uint64_t* dst, int width, int half, RowScratch& scratch) {
+    const int rowWords = (width + 63) / 64;
+    const int window = 2 * half + 1;
+    const int tailBits = width & 63;
+    const uint64_t tailMask = (tailBits == 0) ? ~uint64_t(0) : (uint64_t(1) << tailBits) - 1;
+
+    if (half == 0) {
+        std::copy(src, src + rowWords, dst);
+        dst[rowWords - 1] &= tailMask;
+        return;
+    }
+
+    // Row followed by identity bits
+    uint64_t* c = scratch.window.data();
+    uint64_t* t = scratch.shifted.data();
+    std::fill(c, c + scratch.words, Op::identity);
+    std::copy(src, src + rowWords, c);
+    c[rowWords - 1] = (c[rowWords - 1] & tailMask) | (Op::identity & ~tailMask);
+
+    // c[j] = op over [j - s + 1, j], doubling s up to the largest power of two <= window
+    int s = 1;
+    while (2 * s <= window) {
+        shiftTowardHigher(c, t, scratch.words, s, Op::identity);
+        for (int k = 0; k < scratch.words; ++k) c[k] = Op::apply(c[k], t[k]);
+        s *= 2;
+    }
+    if (window > s) {
+        shiftTowardHigher(c, t, scratch.words, window - s, Op::identity);
+        for (int k = 0; k < scratch.words; ++k) c[k] = Op::apply(c[k], t[k]);
+    }
+
+    // Centered window: dst[j] = c[j + half]
+    shiftTowardLower(c, t, scratch.words, half, Op::identity);
+    std::copy(t, t + rowWords, dst);
+    dst[rowWords - 1] &= tailMask;
+}
+
+template <typename Op>
+void windowRowPass(const PackedBinaryImage& src, PackedBinaryImage& dst, int half) {
+    RowScratch scratch(src.width(), half);
+    for (int r = 0; r < src.height(); ++r) {
+        windowRow<Op>(src.row(r), dst.row(r), src.width(), half, scratch);
+    }
+}
+
+// Van Herk/Gil-Werman along columns, one word row at a time
+template <typename Op>
+void windowColumnPass(const PackedBinaryImage& src, PackedBinaryImage& dst, int half) {
+    const int rows = src.height();
+    const int words = src.wordsPerRow();
+    const int window = 2 * half + 1;
+    const int length = ((rows + 2 * half + window - 1) / window) * window;
+
+    std::vector<uint64_t> identityRow(words, Op::identity);
+    std::vector<uint64_t> prefix(static_cast<size_t>(length) * words);
+    std::vector<uint64_t> suffix(static_cast<size_t>(length) * words);
+
+    auto paddedRow = [&](int p) -> const uint64_t* {
+        int r = p - half;
+        return (r >= 0 && r < rows) ? src.row(r) : identityRow.data();
+    };
+    auto prefixRow = [&](int p) { return prefix.data() + static_cast<size_t>(p) * words; };
+    auto suffixRow = [&](int p) { return suffix.data() + static_cast<size_t>(p) * words; };
+
+    for (int blockStart = 0; blockStart < length; blockStart += window) {
+        int blockEnd = blockStart + window - 1;
+
+        std::copy(paddedRow(blockStart), paddedRow(blockStart) + words, prefixRow(blockStart));
+        for (int p = blockStart + 1; p <= blockEnd; ++p) {
+            const uint64_t* in = paddedRow(p);
+            const uint64_t* previous = prefixRow(p - 1);
+            uint64_t* current = prefixRow(p);
+            for (int k = 0; k < words; ++k) current[k] = Op::apply(previous[k], in[k]);
+        }
+
+        std::copy(paddedRow(blockEnd), paddedRow(blockEnd) + words, suffixRow(blockEnd));
+        for (int p = blockEnd - 1; p >= blockStart; --p) {
+            const uint64_t* in = paddedRow(p);
+            const uint64_t* next = suffixRow(p + 1);
+            uint64_t* current = suffixRow(p);
+            for (int k = 0; k < words; ++k) current[k] = Op::apply(next[k], in[k]);
+        }
+    }
+
+    const uint64_t tailMask = src.lastWordMask();
+    for (int x = 0; x < rows; ++x) {
+        const uint64_t* top = suffixRow(x);
+        const uint64_t* bottom = prefixRow(x + window - 1);
+        uint64_t* out = dst.row(x);
+        for (int k = 0; k < words; ++k) out[k] = Op::apply(top[k], bottom[k]);
+        out[words - 1] &= tailMask;
+    }
+}
+
+template <typename Op>
+PackedBinaryImage rectangularMorphology(const PackedBinaryImage& inputImage, int kernelColumns, int kernelRows) {
+    if (inputImage.width() <= 0 || inputImage.height() <= 0) {
+        throw std::invalid_argument("Invalid packed binary image!");
+    }
+
+    PackedBinaryImage rowPass(inputImage.width(), inputImage.height());
+    PackedBinaryImage output(inputImage.width(), inputImage.height());
+
+    windowRowPass<Op>(inputImage, rowPass, kernelColumns / 2);
+    windowColumnPass<Op>(rowPass, output, kernelRows / 2);
+
+    return output;
+}
+
+// Grows `seed` along the runs of `mask` it touches (both directions), within one row.
+// Kogge-Stone occluded fill inside each word, with the carry handed to the neighbouring word.
+void fillRuns(const uint64_t* seed, const uint64_t* mask, uint64_t* out, int words) {
+    uint64_t carry = 0;
+    for (int k = 0; k < words; ++k) {
+        uint64_t p = mask[k];
+        uint64_t g = (seed[k] | carry) & p;
+        g |= p & (g << 1);  p &= p << 1;
+        g |= p & (g << 2);  p &= p << 2;
+        g |= p & (g << 4);  p &= p << 4;
+        g |= p & (g << 8);  p &= p << 8;
+        g |= p & (g << 16); p &= p << 16;
+        g |= p & (g << 32);
+        out[k] = g;
+        carry = g >> 63;
+    }
+
+    carry = 0;
+    for (int k = words - 1; k >= 0; --k) {
+        uint64_t p = mask[k];
+        uint64_t g = (seed[k] | out[k] | carry) & p;
+        g |= p & (g >> 1);  p &= p >> 1;
+        g |= p & (g >> 2);  p &= p >> 2;
+        g |= p & (g >> 4);  p &= p >> 4;
+        g |= p & (g >> 8);  p &= p >> 8;
+        g |= p & (g >> 16); p &= p >> 16;
+        g |= p & (g >> 32);
+        out[k] |= g;
+        carry = (g & 1) << 63;
+    }
+}
+
+// Fills `reached` (a subset of `background`) to everything connected to it through background pixels,
+// using the structuring element offsets as the neighbourhood.
+void reconstructBackground(PackedBinaryImage& reached, const PackedBinaryImage& background,
+                           int kernelColumns, int kernelRows) {
+    const int rows = background.height();
+    const int cols = background.width();
+    const int words = background.wordsPerRow();
+    const int halfColumns = kernelColumns / 2;
+    const int halfRows = kernelRows / 2;
+
+    // Within a row, background pixels up to halfColumns apart are neighbours. Bridging the background
+    // gaps shorter than halfColumns turns those neighbourhoods into plain runs for fillRuns.
+    PackedBinaryImage runMask = background;
+    if (halfColumns > 1) {
+        std::vector<uint64_t> left(words), right(words), shifted(words);
+        for (int r = 0; r < rows; ++r) {
+            const uint64_t* m = background.row(r);
+            uint64_t* bridged = runMask.row(r);
+            std::fill(right.begin(), right.end(), 0);
+            for (int d = halfColumns - 1; d >= 1; --d) {
+                // right: background within [j + 1, j + halfColumns - d]; left: background at j - d
+                shiftTowardLower(m, shifted.data(), words, halfColumns - d, 0);
+                for (int k = 0; k < words; ++k) right[k] |= shifted[k];
+                shiftTowardHigher(m, left.data(), words, d, 0);
+                for (int k = 0; k < words; ++k) bridged[k] |= left[k] & right[k];
+            }
+            bridged[words - 1] &= background.lastWordMask();
+        }
+    }
+
+    RowScratch scratch(cols, halfColumns);
+    std::vector<uint64_t> neighbours(words), spread(words), grown(words);
+
+    auto sweep = [&](int start, int end, int step) {
+        bool changed = false;
+        for (int r = start; r != end; r += step) {
+            // Pixels reached in the previous halfRows rows of this sweep direction
+            std::fill(neighbours.begin(), neighbours.end(), 0);
+            for (int dr = 1; dr <= halfRows; ++dr) {
+                int source = r - dr * step;
+                if (source < 0 || source >= rows) break;
+                const uint64_t* src = reached.row(source);
+                for (int k = 0; k < words; ++k) neighbours[k] |= src[k];
+            }
+            windowRow<WordOr>(neighbours.data(), spread.data(), cols, halfColumns, scratch);
+
+            uint64_t* current = reached.row(r);
+            const uint64_t* m = background.row(r);
+            for (int k = 0; k < words; ++k) spread[k] = (spread[k] | current[k]) & m[k];
+
+            if (halfColumns > 0) {
+                fillRuns(spread.data(), runMask.row(r), grown.data(), words);
+                for (int k = 0; k < words; ++k) grown[k] &= m[k];
+            } else {
+                grown = spread;
+            }
+
+            for (int k = 0; k < words; ++k) {
+                if (grown[k] != current[k]) {
+                    changed = true;
+                    current[k] = grown[k];
+                }
+            }
+        }
+        return changed;
+    };
+
+    bool changed = true;
+    while (changed) {
+        bool forward = sweep(0, rows, 1);
+        bool backward = sweep(rows - 1, -1, -1);
+        changed = forward || backward;
+    }
+}
+
+PackedBinaryImage complementOf(const PackedBinaryImage& image) {
+    PackedBinaryImage complement(image.width(), image.height());
+    for (int r = 0; r < image.height(); ++r) {
+        const uint64_t* src = image.row(r);
+        uint64_t* dst = complement.row(r);
+        for (int k = 0; k < image.wordsPerRow(); ++k) dst[k] = ~src[k];
+        dst[image.wordsPerRow() - 1] &= image.lastWordMask();
+    }
+    return complement;
+}
+
+} // namespace
+
+PackedBinaryImage applyErosion(const PackedBinaryImage& inputImage, int kernelColumns, int kernelRows) {
+    return rectangularMorphology<WordAnd>(inputImage, kernelColumns, kernelRows);
+}
+
+PackedBinaryImage applyDilation(const PackedBinaryImage& inputImage, int kernelColumns, int kernelRows) {
+    return rectangularMorphology<WordOr>(inputImage, kernelColumns, kernelRows);
+}
+
+PackedBinaryImage applyOpening(const PackedBinaryImage& inputImage, int kernelColumns, int kernelRows) {
+    return applyDilation(applyErosion(inputImage, kernelColumns, kernelRows), kernelColumns, kernelRows);
+}
+
+PackedBinaryImage applyClosing(const PackedBinaryImage& inputImage, int kernelColumns, int kernelRows) {
+    return applyErosion(applyDilation(inputImage, kernelColumns, kernelRows), kernelColumns, kernelRows);
+}
+
+PackedBinaryImage applyBoundaryExtraction(const PackedBinaryImage& inputImage, int kernelColumns, int kernelRows) {
+    // A minus (A eroded by B)
+    PackedBinaryImage boundary = applyErosion(inputImage, kernelColumns, kernelRows);
+    for (int r = 0; r < inputImage.height(); ++r) {
+        const uint64_t* src = inputImage.row(r);
+        uint64_t* dst = boundary.row(r);
+        for (int k = 0; k < inputImage.wordsPerRow(); ++k) dst[k] = src[k] & ~dst[k];
+    }
+    return boundary;
+}
+
+PackedBinaryImage applyHoleFilling(const PackedBinaryImage& inputImage, const std::pair<int, int>& seedPoint, int kernelColumns, int kernelRows) {
+    return applyMultiSeedHoleFilling(inputImage, {seedPoint}, kernelColumns, kernelRows);
+}
+
+PackedBinaryImage applyMultiSeedHoleFilling(const PackedBinaryImage& inputImage, const std::vector<std::pair<int, int>>& seedPoints, int kernelColumns, int kernelRows) {
+    PackedBinaryImage seeds(inputImage.width(), inputImage.height());
+    for (const auto& seed : seedPoints) {
+        if (seed.first < 0 || seed.first >= inputImage.height() || seed.second < 0 || seed.second >= inputImage.width()) {
+            throw std::invalid_argument("Seed point (" + std::to_string(seed.first) + ", " +
+                                        std::to_string(seed.second) + ") is outside the image!");
+        }
+        seeds.set(seed.first, seed.second, true);
+    }
+
+    PackedBinaryImage background = complementOf(inputImage);
+
+    // X_1 = (X_0 dilated by B) intersected with the background, then grow to the fixed point
+    PackedBinaryImage filled = applyDilation(seeds, kernelColumns, kernelRows);
+    for (int r = 0; r < filled.height(); ++r) {
+        uint64_t* dst = filled.row(r);
+        const uint64_t* m = background.row(r);
+        for (int k = 0; k < filled.wordsPerRow(); ++k) dst[k] &= m[k];
+    }
+    reconstructBackground(filled, background, kernelColumns, kernelRows);
+
+    // Add the filled region to the original image
+    for (int r = 0; r < filled.height(); ++r) {
+        uint64_t* dst = filled.row(r);
+        const uint64_t* src = inputImage.row(r);
+        for (int k = 0; k < filled.wordsPerRow(); ++k) dst[k] |= src[k];
+    }
+    return filled;
+}
+
+PackedBinaryImage applyAutomaticHoleFilling(const PackedBinaryImage& inputImage, int kernelColumns, int kernelRows) {
+    const int rows = inputImage.height();
+    const int words = inputImage.wordsPerRow();
+
+    PackedBinaryImage background = complementOf(inputImage);
+
+    // Seed with the background on the image border
+    PackedBinaryImage outside(inputImage.width(), rows);
+    std::copy(background.row(0), background.row(0) + words, outside.row(0));
+    std::copy(background.row(rows - 1), background.row(rows - 1) + words, outside.row(rows - 1));
+    for (int r = 1; r < rows - 1; ++r) {
+        outside.set(r, 0, background.get(r, 0));
+        outside.set(r, inputImage.width() - 1, background.get(r, inputImage.width() - 1));
+    }
+    reconstructBackground(outside, background, kernelColumns, kernelRows);
+
+    // Foreground plus every background pixel the border could not reach
+    PackedBinaryImage filled(inputImage.width(), rows);
+    for (int r = 0; r < rows; ++r) {
+        uint64_t* dst = filled.row(r);
+        const uint64_t* src = inputImage.row(r);
+        const uint64_t* out = outside.row(r);
+        for (int k = 0; k < words; ++k) dst[k] = src[k] | ~out[k];
+        dst[words - 1] &= inputImage.lastWordMask();
+    }
+    return filled;
+}
@@ -0,0 +1,203 @@
+#include "Convolution3x3.h"
+#include <algorithm>
+#include <atomic>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define CONVOLUTION_X86_DISPATCH 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// The non-zero taps of a kernel; zero taps (a third of Sobel/Prewitt, most of Roberts) cost nothing
+struct TapList {
+    int count = 0;
+    int row[9];
+    int column[9];
+    int16_t weight[9];
+};
+
+TapList makeTapList(const Kernel3x3& kernel) {
+    TapList taps;
+    for (int a = 0; a < 3; ++a) {
+        for (int b = 0; b < 3; ++b) {
+            if (kernel.taps[a][b] != 0) {
+                taps.row[taps.count] = a;
+                taps.column[taps.count] = b;
+                taps.weight[taps.count] = static_cast<int16_t>(kernel.taps[a][b]);
+                ++taps.count;
+            }
+        }
+    }
+    return taps;
+}
+
+inline int convolvePixel(const uint8_t* const rows[3], const TapList& taps, int j) {
+    int sum = 0;
+    for (int t = 0; t < taps.count; ++t) {
+        sum += taps.weight[t] * rows[taps.row[t]][j + taps.column[t]];
+    }
+    return sum;
+}
+
+// Scalar path, also used for the tails of the vector paths
+void convolveScalar(const uint8_t* const rows[3], int begin, int count, const TapList& taps,
+                    int16_t* output16, uint8_t* output8) {
+    for (int j = begin; j < count; ++j) {
+        int sum = convolvePixel(rows, taps, j);
+        if (output16) {
+            output16[j] = static_cast<int16_t>(sum);
+        } else {
+            output8[j] = static_cast<uint8_t>(std::clamp(sum, 0, 255));
+        }
+    }
+}
+
+#ifdef CONVOLUTION_X86_DISPATCH
+
+__attribute__((target("sse4.1")))
+void convolveSse41(const uint8_t* const rows[3], int count, const TapList& taps, int16_t* output16, uint8_t* output8) {
+    __m128i weights[9];
+    for (int t = 0; t < taps.count; ++t) {
+        weights[t] = _mm_set1_epi16(taps.weight[t]);
+    }
+
+    int j = 0;
+    for (; j + 8 <= count; j += 8) {
+        __m128i sum = _mm_setzero_si128();
+        for (int t = 0; t < taps.count; ++t) {
+            const uint8_t* source = rows[taps.row[t]] + j + taps.column[t];
+            __m128i pixels = _mm_cvtepu8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(source)));
+            sum = _mm_add_epi16(sum, _mm_mullo_epi16(pixels, weights[t]));
+        }
+        if (output16) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output16 + j), sum);
+        } else {
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(output8 + j), _mm_packus_epi16(sum, sum));
+        }
+    }
+    convolveScalar(rows, j, count, taps, output16, output8);
+}
+
+__attribute__((target("avx2")))
+void convolveAvx2(const uint8_t* const rows[3], int count, const TapList& taps, int16_t* output16, uint8_t* output8) {
+    __m256i weights[9];
+    for (int t = 0; t < taps.count; ++t) {
+        weights[t] = _mm256_set1_epi16(taps.weight[t]);
+    }
+
+    int j = 0;
+    for (; j + 16 <= count; j += 16) {
+        __m256i sum = _mm256_setzero_si256();
+        for (int t = 0; t < taps.count; ++t) {
+            const uint8_t* source = rows[taps.row[t]] + j + taps.column[t];
+            __m256i pixels = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source)));
+            sum = _mm256_add_epi16(sum, _mm256_mullo_epi16(pixels, weights[t]));
+        }
+        if (output16) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(output16 + j), sum);
+        } else {
+            // packus works per 128-bit lane; gather the two low quadwords back together
+            __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(sum, sum), 0x08);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output8 + j), _mm256_castsi256_si128(packed));
+        }
+    }
+    convolveScalar(rows, j, count, taps, output16, output8);
+}
+
+__attribute__((target("avx512f,avx512bw")))
+void convolveAvx512(const uint8_t* const rows[3], int count, const TapList& taps, int16_t* output16, uint8_t* output8) {
+    __m512i weights[9];
+    for (int t = 0; t < taps.count; ++t) {
+        weights[t] = _mm512_set1_epi16(taps.weight[t]);
+    }
+    const __m512i zero = _mm512_setzero_si512();
+
+    int j = 0;
+    for (; j + 32 <= count; j += 32) {
+        __m512i sum = _mm512_setzero_si512();
+        for (int t = 0; t < taps.count; ++t) {
+            const uint8_t* source = rows[taps.row[t]] + j + taps.column[t];
+            __m512i pixels = _mm512_cvtepu8_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(source)));
+            sum = _mm512_add_epi16(sum, _mm512_mullo_epi16(pixels, weights[t]));
+        }
+        if (output16) {
+            _mm512_storeu_si512(output16 + j, sum);
+        } else {
+            // Unsigned saturation only clamps the top, so clear the negatives first
+            __m256i packed = _mm512_cvtusepi16_epi8(_mm512_max_epi16(sum, zero));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(output8 + j), packed);
+        }
+    }
+    convolveScalar(rows, j, count, taps, output16, output8);
+}
+
+#endif // CONVOLUTION_X86_DISPATCH
+
+std::atomic<int> selectedLevel{-1};
+
+void dispatch(const uint8_t* const rows[3], int count, const Kernel3x3& kernel, int16_t* output16, uint8_t* output8) {
+    if (count <= 0) {
+        return;
+    }
+    TapList taps = makeTapList(kernel);
+
+    switch (activeSimdLevel()) {
+#ifdef CONVOLUTION_X86_DISPATCH
+        case SimdLevel::AVX512:
+            convolveAvx512(rows, count, taps, output16, output8);
+            return;
+        case SimdLevel::AVX2:
+            convolveAvx2(rows, count, taps, output16, output8);
+            return;
+        case SimdLevel::SSE41:
+            convolveSse41(rows, count, taps, output16, output8);
+            return;
+#endif
+        default:
+            convolveScalar(rows, 0, count, taps, output16, output8);
+            return;
+    }
+}
+
+} // namespace
+
+SimdLevel detectSimdLevel() {
+#ifdef CONVOLUTION_X86_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512bw")) return SimdLevel::AVX512;
+    if (__builtin_cpu_supports("avx2")) return SimdLevel::AVX2;
+    if (__builtin_cpu_supports("sse4.1")) return SimdLevel::SSE41;
+#endif
+    return SimdLevel::SCALAR;
+}
+
+SimdLevel activeSimdLevel() {
+    int level = selectedLevel.load(std::memory_order_relaxed);
+    if (level < 0) {
+        level = static_cast<int>(detectSimdLevel());
+        selectedLevel.store(level, std::memory_order_relaxed);
+    }
+    return static_cast<SimdLevel>(level);
+}
+
+void setSimdLevel(SimdLevel level) {
+    selectedLevel.store(std::min(static_cast<int>(level), static_cast<int>(detectSimdLevel())));
+}
+
+const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::SSE41:  return "SSE4.1";
+        case SimdLevel::AVX2:   return "AVX2";
+        case SimdLevel::AVX512: return "AVX-512";
+        default:                return "scalar";
+    }
+}
+
+void convolveRow3x3(const uint8_t* const rows[3], int count, const Kernel3x3& kernel, int16_t* output) {
+    dispatch(rows, count, kernel, output, nullptr);
+}
+
+void convolveRow3x3Saturate(const uint8_t* const rows[3], int count, const Kernel3x3& kernel, uint8_t* output) {
+    dispatch(rows, count, kernel, nullptr, output);
+}
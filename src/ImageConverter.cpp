@@ -1,4 +1,13 @@
 #include "ImageConverter.h"
+#include "ImageFilter.h"
+#include "ImageHistogram.h"
+#include "LookupTable.h"
+#include "ThreadPool.h"
+#include "Image.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
 
 std::vector<uint8_t> applyGrayscaleToBinary(const ImageReadResult& inputImage, int threshold) {
     const uint8_t* buffer = inputImage.buffer->data();
@@ -10,10 +19,250 @@ std::vector<uint8_t> applyGrayscaleToBinary(const ImageReadResult& inputImage, i
     // Use the provided output buffer or create a new one
     std::vector<uint8_t> outputBuffer(rows * cols, 0);
 
-    for (int i = 0; i < rows * cols; ++i) {
-        outputBuffer[i] = (buffer[i] > threshold) ? 255 : 0; // Set binary values: 255 for white, 0 for black
-    }
+    // Set binary values: 255 for white, 0 for black
+    applyLookupTable(thresholdTable(threshold), buffer, outputBuffer.data(), outputBuffer.size());
 
     return outputBuffer;
 
 }
+
+// Otsu ----
+
+int otsuThreshold(const std::vector<uint64_t>& histogram) {
+    if (histogram.size() != 256) {
+        throw std::invalid_argument("Otsu's threshold needs a 256-bin histogram!");
+    }
+
+    double total = 0.0;
+    double totalSum = 0.0;
+    for (int v = 0; v < 256; ++v) {
+        total += static_cast<double>(histogram[v]);
+        totalSum += static_cast<double>(v) * histogram[v];
+    }
+
+    // Between-class variance of [0, t] and (t, 255]: w0 * w1 * (mean0 - mean1)^2
+    double weight0 = 0.0;
+    double sum0 = 0.0;
+    double bestVariance = -1.0;
+    int bestThreshold = 0;
+    for (int t = 0; t < 256; ++t) {
+        weight0 += static_cast<double>(histogram[t]);
+        sum0 += static_cast<double>(t) * histogram[t];
+        double weight1 = total - weight0;
+        if (weight0 == 0.0) {
+            continue;
+        }
+        if (weight1 == 0.0) {
+            break;
+        }
+
+        double meanDifference = sum0 / weight0 - (totalSum - sum0) / weight1;
+        double variance = weight0 * weight1 * meanDifference * meanDifference;
+        if (variance > bestVariance) {
+            bestVariance = variance;
+            bestThreshold = t;
+        }
+    }
+    return bestThreshold;
+}
+
+std::vector<uint8_t> applyOtsuThreshold(const ImageReadResult& inputImage) {
+    if (!inputImage.buffer || inputImage.meta.bitDepth != 8) {
+        throw std::invalid_argument("Otsu's threshold needs an 8-bit grayscale image!");
+    }
+    int threshold = otsuThreshold(computeHistogram(makeGrayscaleView(inputImage)));
+    return applyGrayscaleToBinary(inputImage, threshold);
+}
+
+// Adaptive Threshold ----
+
+namespace {
+
+/* Window sums come from integral images, kept one row at a time: running sums of the pixels (and their
+ * squares) of every column over the window rows, updated by one entering and one leaving row per image
+ * row, and their prefix sums along the row. Any window sum is then a difference of two prefix sums, so
+ * the cost per pixel does not depend on the window size and the memory is O(width) instead of two
+ * 64-bit tables of the whole image.
+ *
+ * LocalThreshold holds what is shared by all rows; every thread walks its range of rows with its own
+ * WindowSums.
+ */
+
+struct WindowSums {
+    int firstRow = 0;                       // window rows [firstRow, lastRow) are in the column sums
+    int lastRow = 0;
+    std::vector<uint32_t> columnSums;
+    std::vector<uint64_t> columnSquares;
+    std::vector<double> prefixSums;         // prefixSums[c] = sum of columnSums[0, c), exact below 2^53
+    std::vector<double> prefixSquares;
+};
+
+class LocalThreshold {
+public:
+    LocalThreshold(const ImageView& input, AdaptiveThresholdMethod method, int windowSize, double k, double offset)
+        : input_(input), method_(method), halfWindow_(windowSize / 2), k_(k), offset_(offset) {
+        if (!input.isValid() || input.channels != 1) {
+            throw std::invalid_argument("Adaptive threshold needs a valid single-channel view!");
+        }
+        if (windowSize < 3 || windowSize % 2 == 0) {
+            throw std::invalid_argument("Adaptive threshold window must be odd and at least 3!");
+        }
+
+        if (method == AdaptiveThresholdMethod::GAUSSIAN) {
+            double sigma = 0.3 * ((windowSize - 1) * 0.5 - 1) + 0.8;
+            computeWeightedMeans(createGaussianKernel1D(halfWindow_, sigma));
+        }
+    }
+
+    void row(int r, WindowSums& sums, uint8_t* output) const {
+        const uint8_t* pixels = input_.row(r);
+        const int width = input_.width;
+
+        if (method_ == AdaptiveThresholdMethod::GAUSSIAN) {
+            const float* means = weightedMeans_.view().row(r);
+            const float offset = static_cast<float>(offset_);
+            for (int c = 0; c < width; ++c) {
+                output[c] = (pixels[c] > means[c] - offset) ? 255 : 0;
+            }
+            return;
+        }
+
+        const bool needSquares = (method_ != AdaptiveThresholdMethod::MEAN);
+        moveWindow(sums, std::max(r - halfWindow_, 0), std::min(r + halfWindow_ + 1, input_.height), needSquares);
+
+        // Columns whose window is cut by the left or right border, then the interior, where the window
+        // always has the same size and the loop vectorizes
+        const int interiorBegin = std::min(halfWindow_, width);
+        const int interiorEnd = std::max(width - halfWindow_, interiorBegin);
+        auto thresholdColumns = [&](int begin, int end) {
+            for (int c = begin; c < end; ++c) {
+                int left = std::max(c - halfWindow_, 0);
+                int right = std::min(c + halfWindow_ + 1, width);
+                output[c] = thresholdPixel(pixels[c], sums, left, right);
+            }
+        };
+        thresholdColumns(0, interiorBegin);
+        for (int c = interiorBegin; c < interiorEnd; ++c) {
+            output[c] = thresholdPixel(pixels[c], sums, c - halfWindow_, c + halfWindow_ + 1);
+        }
+        thresholdColumns(interiorEnd, width);
+    }
+
+private:
+    // Separable Gaussian of the window, renormalized where it is clipped like the other means, and kept in
+    // float so the comparison is not biased by rounding
+    void computeWeightedMeans(const std::vector<float>& kernel) {
+        weightedMeans_ = Image<float>(input_.width, input_.height);
+        parallelRowBands(input_, weightedMeans_.view(), halfWindow_,
+                         [&kernel](const ImageView& band, const BasicImageView<float>& bandOutput) {
+            Image<float> temp(band.width, band.height);
+            convolveRowsGaussian(band, temp.view(), kernel);
+            convolveColumnsGaussian(std::as_const(temp).view(), bandOutput, kernel);
+        });
+    }
+
+    uint8_t thresholdPixel(uint8_t pixel, const WindowSums& sums, int left, int right) const {
+        double count = static_cast<double>(sums.lastRow - sums.firstRow) * (right - left);
+        double mean = (sums.prefixSums[right] - sums.prefixSums[left]) / count;
+
+        double threshold = mean;
+        if (method_ != AdaptiveThresholdMethod::MEAN) {
+            double variance = (sums.prefixSquares[right] - sums.prefixSquares[left]) / count - mean * mean;
+            double deviation = std::sqrt(std::max(variance, 0.0));
+            threshold = (method_ == AdaptiveThresholdMethod::NIBLACK)
+                ? mean + k_ * deviation
+                : mean * (1.0 + k_ * (deviation / 128.0 - 1.0));
+        }
+        return (pixel > threshold - offset_) ? 255 : 0;
+    }
+
+    // Brings the column sums to the window rows [firstRow, lastRow) and rebuilds the prefix sums
+    void moveWindow(WindowSums& sums, int firstRow, int lastRow, bool needSquares) const {
+        const int width = input_.width;
+        if (sums.columnSums.empty() || firstRow >= sums.lastRow) {
+            sums.columnSums.assign(width, 0);
+            sums.columnSquares.assign(needSquares ? width : 0, 0);
+            sums.prefixSums.assign(width + 1, 0);
+            sums.prefixSquares.assign(needSquares ? width + 1 : 0, 0);
+            sums.firstRow = sums.lastRow = firstRow;
+        }
+
+        for (; sums.lastRow < lastRow; ++sums.lastRow) {
+            const uint8_t* pixels = input_.row(sums.lastRow);
+            for (int c = 0; c < width; ++c) {
+                sums.columnSums[c] += pixels[c];
+            }
+            for (int c = 0; needSquares && c < width; ++c) {
+                sums.columnSquares[c] += pixels[c] * pixels[c];
+            }
+        }
+        for (; sums.firstRow < firstRow; ++sums.firstRow) {
+            const uint8_t* pixels = input_.row(sums.firstRow);
+            for (int c = 0; c < width; ++c) {
+                sums.columnSums[c] -= pixels[c];
+            }
+            for (int c = 0; needSquares && c < width; ++c) {
+                sums.columnSquares[c] -= pixels[c] * pixels[c];
+            }
+        }
+
+        for (int c = 0; c < width; ++c) {
+            sums.prefixSums[c + 1] = sums.prefixSums[c] + sums.columnSums[c];
+        }
+        if (needSquares) {
+            for (int c = 0; c < width; ++c) {
+                sums.prefixSquares[c + 1] = sums.prefixSquares[c] + sums.columnSquares[c];
+            }
+        }
+    }
+
+    ImageView input_;
+    AdaptiveThresholdMethod method_;
+    int halfWindow_;
+    double k_;
+    double offset_;
+    Image<float> weightedMeans_;
+};
+
+} // namespace
+
+void applyAdaptiveThreshold(const ImageView& input, const MutableImageView& output,
+                            AdaptiveThresholdMethod method, int windowSize, double k, double offset) {
+    requireSameSize(input, output);
+    LocalThreshold threshold(input, method, windowSize, k, offset);
+
+    parallelRowRanges(input.height, 16, [&](int rowBegin, int rowEnd) {
+        WindowSums sums;
+        for (int r = rowBegin; r < rowEnd; ++r) {
+            threshold.row(r, sums, output.row(r));
+        }
+    });
+}
+
+void applyAdaptiveThreshold(const ImageView& input, PackedBinaryImage& output,
+                            AdaptiveThresholdMethod method, int windowSize, double k, double offset) {
+    LocalThreshold threshold(input, method, windowSize, k, offset);
+    output = PackedBinaryImage(input.width, input.height);
+
+    parallelRowRanges(input.height, 16, [&](int rowBegin, int rowEnd) {
+        WindowSums sums;
+        std::vector<uint8_t> rowBuffer(input.width);
+        for (int r = rowBegin; r < rowEnd; ++r) {
+            threshold.row(r, sums, rowBuffer.data());
+            output.packRow(r, rowBuffer.data());
+        }
+    });
+}
+
+std::vector<uint8_t> applyAdaptiveThreshold(const ImageReadResult& inputImage,
+                                            AdaptiveThresholdMethod method, int windowSize, double k, double offset) {
+    const ImageMetadata& meta = inputImage.meta;
+    if (!inputImage.buffer || meta.bitDepth != 8) {
+        throw std::invalid_argument("Adaptive threshold needs an 8-bit grayscale image!");
+    }
+
+    std::vector<uint8_t> outputBuffer(static_cast<size_t>(meta.width) * meta.height);
+    applyAdaptiveThreshold(makeGrayscaleView(inputImage), makeImageView(outputBuffer.data(), meta.width, meta.height),
+                           method, windowSize, k, offset);
+    return outputBuffer;
+}
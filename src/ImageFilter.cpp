@@ -1,158 +1,601 @@
 #include "ImageFilter.h"
+#include "ThreadPool.h"
+#include "Convolution3x3.h"
+#include "Image.h"
+#include <complex>
+#include <type_traits>
+#include <utility>
 
 
 // Box Filter ----------------------------------------------------------------------------
 
+/* The box filter keeps one running sum per column for the current vertical window and slides a
+ * horizontal window over those column sums, so every output pixel costs a constant number of
+ * additions regardless of the kernel size.
+ *
+ * As we are not using any padding, a 3*3 kernel does not mean that we are always considering 9 pixels.
+ * Near the border only the in-bounds pixels are averaged; their count is (rows in window) * (cols in window).
+ */
+
 std::vector<uint8_t> applyBoxFilter(const ImageReadResult& inputImage, int kernelSize) {
     if (!inputImage.meta.isValid() || !inputImage.buffer.has_value()) {
         throw std::invalid_argument("Invalid image metadata or missing buffer!");
     }
 
-    // Access the buffer
-    const uint8_t* buffer = inputImage.buffer->data();
-    const ImageMetadata& meta = inputImage.meta;
+    return applyBoxFilter(makeGrayscaleView(inputImage), kernelSize);
+}
 
-    int rows = meta.height;
-    int cols = meta.width;
-    int halfKernel = kernelSize / 2;
+namespace {
 
-    // Create a copy of the buffer for the filtered result
-    std::vector<uint8_t> outputBuffer(rows * cols, 0);
+void boxFilterBand(const ImageView& input, const MutableImageView& output, int halfKernel) {
+    int rows = input.height;
+    int cols = input.width;
+
+    // Column sums over rows [i - halfKernel, i + halfKernel] clipped to the image
+    std::vector<uint32_t> columnSums(cols, 0);
+    for (int x = 0; x <= std::min(halfKernel, rows - 1); ++x) {
+        const uint8_t* src = input.row(x);
+        for (int j = 0; j < cols; ++j) {
+            columnSums[j] += src[j];
+        }
+    }
 
     // Apply the box filter
     for (int i = 0; i < rows; ++i) {
-        for (int j = 0; j < cols; ++j) {
-            int sum = 0;
-            int count = 0;
+        // Slide the vertical window down by one row (nothing to do for the first row)
+        if (i > 0) {
+            int enteringRow = i + halfKernel;
+            int leavingRow = i - halfKernel - 1;
+
+            if (enteringRow < rows) {
+                const uint8_t* src = input.row(enteringRow);
+                for (int j = 0; j < cols; ++j) {
+                    columnSums[j] += src[j];
+                }
+            }
+            if (leavingRow >= 0) {
+                const uint8_t* src = input.row(leavingRow);
+                for (int j = 0; j < cols; ++j) {
+                    columnSums[j] -= src[j];
+                }
+            }
+        }
 
-            for (int ki = -halfKernel; ki <= halfKernel; ++ki) {
-                for (int kj = -halfKernel; kj <= halfKernel; ++kj) {
-                    int x = i + ki;
-                    int y = j + kj;
+        int rowCount = std::min(i + halfKernel, rows - 1) - std::max(i - halfKernel, 0) + 1;
 
-                    if (x >= 0 && x < rows && y >= 0 && y < cols) {  
-                        /* as we are not using any padding,  
-                        x < rows and y < cols ensure that we are not using any pixels or values outside of image boundary
-                        so, an image kernel of 3*3 does not mean that we are considering 9 pixels always
-                        that's why we need count++ to calculate how many pixels we are considering actually */
+        // Horizontal running sum over the column sums
+        uint64_t sum = 0;
+        for (int y = 0; y <= std::min(halfKernel, cols - 1); ++y) {
+            sum += columnSums[y];
+        }
 
-                        sum += buffer[x * cols + y];
-                        count++;
-                    }
-                }
+        uint8_t* dst = output.row(i);
+        for (int j = 0; j < cols; ++j) {
+            if (j > 0) {
+                int enteringCol = j + halfKernel;
+                int leavingCol = j - halfKernel - 1;
+                if (enteringCol < cols) sum += columnSums[enteringCol];
+                if (leavingCol >= 0)    sum -= columnSums[leavingCol];
             }
 
-            outputBuffer[i * cols + j] = static_cast<uint8_t>(sum / count);
+            int colCount = std::min(j + halfKernel, cols - 1) - std::max(j - halfKernel, 0) + 1;
+            dst[j] = static_cast<uint8_t>(sum / (static_cast<uint64_t>(rowCount) * colCount));
         }
     }
+}
+
+} // namespace
 
+std::vector<uint8_t> applyBoxFilter(const ImageView& input, int kernelSize) {
+    std::vector<uint8_t> outputBuffer(static_cast<size_t>(input.width) * input.height);
+    applyBoxFilter(input, makeImageView(outputBuffer.data(), input.width, input.height), kernelSize);
     return outputBuffer;
 }
 
-// Gaussian Filter ------------------------------------------------------------------------------------------
-
-std::vector<uint8_t> applyGaussianFilter(const ImageReadResult& inputImage, int kernelSize, double sigma) {
-    if (!inputImage.meta.isValid() || !inputImage.buffer.has_value()) {
-        throw std::invalid_argument("Invalid image metadata or missing buffer!");
+void applyBoxFilter(const ImageView& input, const MutableImageView& output, int kernelSize) {
+    if (!input.isValid() || input.channels != 1) {
+        throw std::invalid_argument("Box filter needs a valid single-channel view!");
     }
+    requireSameSize(input, output);
 
-    std::cout << "Gaussian filtering started" <<std::endl;
+    int halfKernel = kernelSize / 2;
+    parallelRowBands(input, output, halfKernel, [halfKernel](const ImageView& band, const MutableImageView& bandOutput) {
+        boxFilterBand(band, bandOutput, halfKernel);
+    });
+}
 
-    const uint8_t* buffer = inputImage.buffer->data();
+// Box filter from a precomputed integral image, so several kernel sizes can share one table
+std::vector<uint8_t> applyBoxFilter(const IntegralImage& integralImage, int kernelSize) {
+    int rows = integralImage.height();
+    int cols = integralImage.width();
+    int halfKernel = kernelSize / 2;
 
-    std::cout << "buffer data collected" <<std::endl;
+    std::vector<uint8_t> outputBuffer(rows * cols, 0);
 
-    const ImageMetadata& meta = inputImage.meta;
+    for (int i = 0; i < rows; ++i) {
+        for (int j = 0; j < cols; ++j) {
+            int top = i - halfKernel, bottom = i + halfKernel;
+            int left = j - halfKernel, right = j + halfKernel;
+            uint64_t sum = integralImage.sum(top, left, bottom, right);
+            int64_t count = integralImage.count(top, left, bottom, right);
+            outputBuffer[i * cols + j] = static_cast<uint8_t>(sum / count);
+        }
+    }
 
-    std::cout << "Meta data collected" <<std::endl;
+    return outputBuffer;
+}
 
-    int rows = meta.height;
-    int cols = meta.width;
-    int halfKernel = kernelSize / 2;
+// Gaussian Filter ------------------------------------------------------------------------------------------
+
+/* The 2-D Gaussian is the outer product of two 1-D Gaussians, so the k x k convolution is done as a
+ * horizontal pass followed by a vertical pass (O(2k) per pixel instead of O(k^2)).
+ *
+ * The old implementation renormalized by the sum of the in-bounds weights at the border. That window is
+ * always a rectangle, so its weight sum factors into (row weight sum) x (column weight sum) and each pass
+ * can renormalize on its own. Only the border strips pay for that; the interior loops are branch free.
+ */
 
-    // Create a 2D Gaussian kernel
-    std::vector<std::vector<double>> kernel(kernelSize, std::vector<double>(kernelSize));
+std::vector<float> createGaussianKernel1D(int halfKernel, double sigma) {
+    std::vector<float> kernel(2 * halfKernel + 1);
     double sum = 0.0;
 
     for (int i = -halfKernel; i <= halfKernel; ++i) {
-        for (int j = -halfKernel; j <= halfKernel; ++j) {
-            double value = std::exp(-(i * i + j * j) / (2 * sigma * sigma)) / (2 * M_PI * sigma * sigma);
-            kernel[i + halfKernel][j + halfKernel] = value;
-            sum += value;
-        }
+        double value = std::exp(-(i * i) / (2 * sigma * sigma));
+        kernel[i + halfKernel] = static_cast<float>(value);
+        sum += value;
     }
 
-    std::cout << "Gaussian kernel created" <<std::endl;
+    for (float& weight : kernel) {
+        weight = static_cast<float>(weight / sum);
+    }
+
+    return kernel;
+}
 
-    // Normalize the kernel
-    for (int i = 0; i < kernelSize; ++i) {
-        for (int j = 0; j < kernelSize; ++j) {
-            kernel[i][j] /= sum;
+void convolveRowsGaussian(const ImageView& input, const BasicImageView<float>& temp, const std::vector<float>& kernel) {
+    const int rows = input.height;
+    const int cols = input.width;
+    const int halfKernel = static_cast<int>(kernel.size()) / 2;
+    const float* k = kernel.data();
+
+    // Columns whose whole window is inside the image
+    const int interiorBegin = std::min(halfKernel, cols);
+    const int interiorEnd = std::max(cols - halfKernel, interiorBegin);
+
+    // Border columns: clip the window and renormalize by the in-bounds weights
+    auto borderPixel = [&](const uint8_t* src, int j) -> float {
+        int kjBegin = std::max(-halfKernel, -j);
+        int kjEnd = std::min(halfKernel, cols - 1 - j);
+
+        float weightedSum = 0.0f;
+        float weightSum = 0.0f;
+        for (int kj = kjBegin; kj <= kjEnd; ++kj) {
+            weightedSum += src[j + kj] * k[kj + halfKernel];
+            weightSum += k[kj + halfKernel];
+        }
+        return weightedSum / weightSum;
+    };
+
+    for (int i = 0; i < rows; ++i) {
+        const uint8_t* src = input.row(i);
+        float* dst = temp.row(i);
+
+        for (int j = 0; j < interiorBegin; ++j) {
+            dst[j] = borderPixel(src, j);
+        }
+
+        // Tap by tap over the whole interior, so the inner loop runs along the row and vectorizes;
+        // every pixel still adds its taps in the same order
+        std::fill(dst + interiorBegin, dst + interiorEnd, 0.0f);
+        for (int t = 0; t < static_cast<int>(kernel.size()); ++t) {
+            const uint8_t* window = src + t - halfKernel;
+            const float weight = k[t];
+            for (int j = interiorBegin; j < interiorEnd; ++j) {
+                dst[j] += window[j] * weight;
+            }
+        }
+
+        for (int j = interiorEnd; j < cols; ++j) {
+            dst[j] = borderPixel(src, j);
         }
     }
+}
 
-    // Create an output buffer
-    std::vector<uint8_t> outputBuffer(rows * cols, 0);
+namespace {
 
-    std::cout << "New buffer created to store the filtered buffer" <<std::endl;
+// Float sums land just below the exact value (a flat 255 region sums to 254.99998), so the truncation to
+// uint8 is nudged by this much; far above the float error, far below one grey level
+constexpr float kTruncationEpsilon = 1e-3f;
+
+// Vertical pass: float rows -> uint8 or float rows. Works on whole rows so the inner loop runs along memory.
+template <typename T>
+void convolveColumnsGaussianTo(const BasicImageView<const float>& temp, const BasicImageView<T>& output,
+                               const std::vector<float>& kernel) {
+    const int rows = temp.height;
+    const int cols = temp.width;
+    const int halfKernel = static_cast<int>(kernel.size()) / 2;
+    std::vector<float> accumulator(cols);
+    std::vector<float> rowWeights(kernel.size());
 
-    // Apply the Gaussian filter
     for (int i = 0; i < rows; ++i) {
+        int kiBegin = std::max(-halfKernel, -i);
+        int kiEnd = std::min(halfKernel, rows - 1 - i);
+
+        // For the top/bottom strips the whole row shares one renormalization factor,
+        // so it is folded into the weights instead of being checked per pixel
+        float weightSum = 0.0f;
+        for (int ki = kiBegin; ki <= kiEnd; ++ki) {
+            weightSum += kernel[ki + halfKernel];
+        }
+        bool isInterior = (kiBegin == -halfKernel && kiEnd == halfKernel);
+        for (int ki = kiBegin; ki <= kiEnd; ++ki) {
+            rowWeights[ki + halfKernel] = isInterior ? kernel[ki + halfKernel] : kernel[ki + halfKernel] / weightSum;
+        }
+
+        std::fill(accumulator.begin(), accumulator.end(), 0.0f);
+        for (int ki = kiBegin; ki <= kiEnd; ++ki) {
+            const float* src = temp.row(i + ki);
+            const float weight = rowWeights[ki + halfKernel];
+            for (int j = 0; j < cols; ++j) {
+                accumulator[j] += src[j] * weight;
+            }
+        }
+
+        T* dst = output.row(i);
         for (int j = 0; j < cols; ++j) {
-            double weightedSum = 0.0;
-            double weightSum = 0.0;
+            if constexpr (std::is_same_v<T, uint8_t>) {
+                dst[j] = static_cast<uint8_t>(std::clamp(accumulator[j] + kTruncationEpsilon, 0.0f, 255.0f));
+            } else {
+                dst[j] = accumulator[j];
+            }
+        }
+    }
+}
 
-            for (int ki = -halfKernel; ki <= halfKernel; ++ki) {
-                for (int kj = -halfKernel; kj <= halfKernel; ++kj) {
-                    int x = i + ki;
-                    int y = j + kj;
+} // namespace
 
-                    if (x >= 0 && x < rows && y >= 0 && y < cols) {
-                        double weight = kernel[ki + halfKernel][kj + halfKernel];
-                        weightedSum += buffer[x * cols + y] * weight;
-                        weightSum += weight;
-                    }
+void convolveColumnsGaussian(const BasicImageView<const float>& input, const BasicImageView<float>& output,
+                             const std::vector<float>& kernel) {
+    convolveColumnsGaussianTo(input, output, kernel);
+}
+
+// Recursive Gaussian Filter --------------------------------------------------------------------------------
+
+/* Young-van Vliet: a causal and an anti-causal third-order recursion along each axis,
+ *
+ *   w[n] = B x[n] + a1 w[n - 1] + a2 w[n - 2] + a3 w[n - 3]
+ *   y[n] = B w[n] + a1 y[n + 1] + a2 y[n + 2] + a3 y[n + 3]
+ *
+ * with B = 1 - a1 - a2 - a3 and the coefficients fitted to sigma, so every pass costs the same few
+ * multiply-adds per pixel whatever sigma is. Outside the image the edge pixels are replicated: the causal
+ * pass starts from the steady state of the first pixel, and the anti-causal one from the Triggs-Sdika
+ * values, which are what an infinitely long replicated border would leave there.
+ *
+ * The vertical pass steps from row to row over whole rows, so the recursion runs along every column at
+ * once and the inner loops are plain row loops. The horizontal pass recurses along the row; blocks of
+ * RECURSIVE_ROW_BLOCK rows are transposed into a scratch buffer so that one step of the recursion is one
+ * vector over the rows of the block.
+ */
+
+namespace {
+
+constexpr int RECURSIVE_ROW_BLOCK = 8;
+constexpr int RECURSIVE_COLUMN_GROUP = 16;   // vertical pass columns per thread, in groups of one cache line
+
+struct RecursiveGaussianCoefficients {
+    float b;
+    float a1;
+    float a2;
+    float a3;
+    float start[3][3];   // anti-causal y[n - 1 + k] = sum over i of start[k][i] * (w[n - 1 - i] - x[n - 1]) + x[n - 1]
+};
+
+RecursiveGaussianCoefficients recursiveGaussianCoefficients(double sigma) {
+    if (!(sigma >= 0.5)) {
+        throw std::invalid_argument("Recursive Gaussian needs sigma >= 0.5!");
+    }
+
+    // van Vliet, Young, Verbeek, "Recursive Gaussian derivative filters", ICPR 1998: the poles of the
+    // causal half (fitted for the smallest maximum error) are scaled as d^(1/q), with q chosen so that the
+    // variance of the whole filter, 2 * sum of d / (d - 1)^2, is sigma^2. It grows with q, so q is bisected.
+    const std::complex<double> poles[3] = {{1.41650, 1.00829}, {1.41650, -1.00829}, {1.86543, 0.0}};
+    auto variance = [&poles](double q) {
+        std::complex<double> sum = 0.0;
+        for (const std::complex<double>& pole : poles) {
+            std::complex<double> scaled = std::pow(pole, 1.0 / q);
+            sum += scaled / ((scaled - 1.0) * (scaled - 1.0));
+        }
+        return 2.0 * sum.real();
+    };
+    double qLow = 0.01;
+    double qHigh = 1000.0;
+    for (int iteration = 0; iteration < 100; ++iteration) {
+        double q = std::sqrt(qLow * qHigh);
+        (variance(q) < sigma * sigma ? qLow : qHigh) = q;
+    }
+
+    // 1 / ((1 - p1 z^-1)(1 - p2 z^-1)(1 - p3 z^-1)) with p = d^(-1/q)
+    std::complex<double> p[3];
+    for (int k = 0; k < 3; ++k) {
+        p[k] = 1.0 / std::pow(poles[k], 1.0 / qLow);
+    }
+    double a1 = (p[0] + p[1] + p[2]).real();
+    double a2 = -(p[0] * p[1] + p[0] * p[2] + p[1] * p[2]).real();
+    double a3 = (p[0] * p[1] * p[2]).real();
+    double b = 1.0 - (a1 + a2 + a3);
+
+    // Triggs, Sdika, "Boundary conditions for Young-van Vliet recursive filtering", IEEE TSP 54 (2006)
+    double scale = b / ((1.0 + a1 - a2 + a3) * (1.0 - a1 - a2 - a3) * (1.0 + a2 + (a1 - a3) * a3));
+    double m[3][3] = {
+        {-a3 * a1 + 1.0 - a3 * a3 - a2, (a3 + a1) * (a2 + a3 * a1), a3 * (a1 + a3 * a2)},
+        {a1 + a3 * a2, -(a2 - 1.0) * (a2 + a3 * a1), -a3 * (a3 * a1 + a3 * a3 + a2 - 1.0)},
+        {a3 * a1 + a2 + a1 * a1 - a2 * a2, a1 * a2 + a3 * a2 * a2 - a1 * a3 * a3 - a3 * a3 * a3 - a3 * a2 + a3,
+         a3 * (a1 + a3 * a2)},
+    };
+
+    RecursiveGaussianCoefficients coefficients;
+    coefficients.b = static_cast<float>(b);
+    coefficients.a1 = static_cast<float>(a1);
+    coefficients.a2 = static_cast<float>(a2);
+    coefficients.a3 = static_cast<float>(a3);
+    for (int k = 0; k < 3; ++k) {
+        for (int i = 0; i < 3; ++i) {
+            coefficients.start[k][i] = static_cast<float>(scale * m[k][i]);
+        }
+    }
+    return coefficients;
+}
+
+/**
+ * Horizontal pass over rows [rowBegin, rowEnd): uint8 rows -> float rows. Column j of lane l sits at
+ * scratch[(j + 3) * RECURSIVE_ROW_BLOCK + l]; the three slots on each side hold the border states.
+ */
+void recursiveGaussianRows(const ImageView& input, const BasicImageView<float>& output, int rowBegin, int rowEnd,
+                           const RecursiveGaussianCoefficients& c) {
+    constexpr int L = RECURSIVE_ROW_BLOCK;
+    const int cols = input.width;
+    std::vector<float> scratch(static_cast<size_t>(cols + 6) * L, 0.0f);
+    float* s = scratch.data();
+
+    for (int blockBegin = rowBegin; blockBegin < rowEnd; blockBegin += L) {
+        // Transposed in L x L tiles, so both sides are read and written a cache line at a time. Lanes past
+        // the end of a short block repeat its last row, and their results are dropped.
+        const int lanes = std::min(L, rowEnd - blockBegin);
+        const uint8_t* sources[L];
+        for (int l = 0; l < L; ++l) {
+            sources[l] = input.row(blockBegin + std::min(l, lanes - 1));
+        }
+        const int tiledCols = cols - cols % L;
+        for (int tile = 0; tile < tiledCols; tile += L) {
+            float* destination = s + (tile + 3) * L;
+            for (int l = 0; l < L; ++l) {
+                const uint8_t* source = sources[l] + tile;
+                for (int j = 0; j < L; ++j) {
+                    destination[j * L + l] = source[j];
                 }
             }
+        }
+        for (int l = 0; l < L; ++l) {
+            for (int j = tiledCols; j < cols; ++j) {
+                s[(j + 3) * L + l] = sources[l][j];
+            }
+        }
+
+        float first[L];
+        float last[L];
+        for (int l = 0; l < L; ++l) {
+            first[l] = s[3 * L + l];
+            last[l] = s[(cols + 2) * L + l];
+        }
+
+        // Causal pass, from the steady state of the first pixel
+        for (int j = 0; j < 3; ++j) {
+            for (int l = 0; l < L; ++l) {
+                s[j * L + l] = first[l];
+            }
+        }
+        for (int j = 3; j < cols + 3; ++j) {
+            float* current = s + j * L;
+            for (int l = 0; l < L; ++l) {
+                current[l] = c.b * current[l] + c.a1 * current[l - L] + c.a2 * current[l - 2 * L] +
+                             c.a3 * current[l - 3 * L];
+            }
+        }
+
+        // Anti-causal pass, from the Triggs-Sdika values at columns cols - 1 .. cols + 1
+        float start[3][L];
+        for (int l = 0; l < L; ++l) {
+            float d0 = s[(cols + 2) * L + l] - last[l];
+            float d1 = s[(cols + 1) * L + l] - last[l];
+            float d2 = s[cols * L + l] - last[l];
+            for (int k = 0; k < 3; ++k) {
+                start[k][l] = c.start[k][0] * d0 + c.start[k][1] * d1 + c.start[k][2] * d2 + last[l];
+            }
+        }
+        for (int k = 0; k < 3; ++k) {
+            for (int l = 0; l < L; ++l) {
+                s[(cols + 2 + k) * L + l] = start[k][l];
+            }
+        }
+        for (int j = cols + 1; j >= 3; --j) {
+            float* current = s + j * L;
+            for (int l = 0; l < L; ++l) {
+                current[l] = c.b * current[l] + c.a1 * current[l + L] + c.a2 * current[l + 2 * L] +
+                             c.a3 * current[l + 3 * L];
+            }
+        }
 
-            outputBuffer[i * cols + j] = static_cast<uint8_t>(weightedSum / weightSum);
+        for (int tile = 0; tile < tiledCols; tile += L) {
+            const float* source = s + (tile + 3) * L;
+            for (int l = 0; l < lanes; ++l) {
+                float* destination = output.row(blockBegin + l) + tile;
+                for (int j = 0; j < L; ++j) {
+                    destination[j] = source[j * L + l];
+                }
+            }
+        }
+        for (int l = 0; l < lanes; ++l) {
+            float* destination = output.row(blockBegin + l);
+            for (int j = tiledCols; j < cols; ++j) {
+                destination[j] = s[(j + 3) * L + l];
+            }
         }
     }
+}
 
-    std::cout << "Applying Gaussian Filter is completed" <<std::endl;
+// Vertical pass over columns [colBegin, colEnd), in place on the output of the horizontal pass
+void recursiveGaussianColumns(const BasicImageView<float>& image, int colBegin, int colEnd,
+                              const RecursiveGaussianCoefficients& c) {
+    const int rows = image.height;
+    const int width = colEnd - colBegin;
+    auto row = [&](int r) { return image.row(std::max(r, 0)) + colBegin; };   // w[-k] = x[0] = w[0]
+
+    // Causal pass; row 0 is its own steady state
+    std::vector<float> last(row(rows - 1), row(rows - 1) + width);
+    for (int r = 1; r < rows; ++r) {
+        float* current = row(r);
+        const float* previous1 = row(r - 1);
+        const float* previous2 = row(r - 2);
+        const float* previous3 = row(r - 3);
+        for (int j = 0; j < width; ++j) {
+            current[j] = c.b * current[j] + c.a1 * previous1[j] + c.a2 * previous2[j] + c.a3 * previous3[j];
+        }
+    }
 
-    return outputBuffer;
+    // Anti-causal pass; rows rows and rows + 1 only exist as its starting values
+    std::vector<float> beyond(2 * static_cast<size_t>(width));
+    {
+        float* current = row(rows - 1);
+        const float* previous1 = row(rows - 2);
+        const float* previous2 = row(rows - 3);
+        for (int j = 0; j < width; ++j) {
+            float d0 = current[j] - last[j];
+            float d1 = previous1[j] - last[j];
+            float d2 = previous2[j] - last[j];
+            beyond[j] = c.start[1][0] * d0 + c.start[1][1] * d1 + c.start[1][2] * d2 + last[j];
+            beyond[width + j] = c.start[2][0] * d0 + c.start[2][1] * d1 + c.start[2][2] * d2 + last[j];
+            current[j] = c.start[0][0] * d0 + c.start[0][1] * d1 + c.start[0][2] * d2 + last[j];
+        }
+    }
+    auto laterRow = [&](int r) { return (r < rows) ? row(r) : beyond.data() + static_cast<size_t>(r - rows) * width; };
+    for (int r = rows - 2; r >= 0; --r) {
+        float* current = row(r);
+        const float* next1 = laterRow(r + 1);
+        const float* next2 = laterRow(r + 2);
+        const float* next3 = laterRow(r + 3);
+        for (int j = 0; j < width; ++j) {
+            current[j] = c.b * current[j] + c.a1 * next1[j] + c.a2 * next2[j] + c.a3 * next3[j];
+        }
+    }
 }
 
+} // namespace
 
-// Median Filter --------------------------------------------------------------------------------------
+void recursiveGaussianFilter(const ImageView& input, const BasicImageView<float>& output, double sigma) {
+    if (!input.isValid() || input.channels != 1) {
+        throw std::invalid_argument("Gaussian filter needs a valid single-channel view!");
+    }
+    requireSameSize(input, output);
+    const RecursiveGaussianCoefficients coefficients = recursiveGaussianCoefficients(sigma);
+
+    parallelRowRanges(input.height, 4 * RECURSIVE_ROW_BLOCK, [&](int rowBegin, int rowEnd) {
+        recursiveGaussianRows(input, output, rowBegin, rowEnd, coefficients);
+    });
+
+    // Every column runs the whole height, so the threads split the columns instead
+    const int groups = (input.width + RECURSIVE_COLUMN_GROUP - 1) / RECURSIVE_COLUMN_GROUP;
+    parallelRowRanges(groups, 4, [&](int groupBegin, int groupEnd) {
+        recursiveGaussianColumns(output, groupBegin * RECURSIVE_COLUMN_GROUP,
+                                 std::min(groupEnd * RECURSIVE_COLUMN_GROUP, input.width), coefficients);
+    });
+}
 
-std::vector<uint8_t> applyMedianFilter(const ImageReadResult& inputImage, int kernelSize) {
+std::vector<uint8_t> applyGaussianFilter(const ImageReadResult& inputImage, int kernelSize, double sigma,
+                                         GaussianEngine engine) {
     if (!inputImage.meta.isValid() || !inputImage.buffer.has_value()) {
         throw std::invalid_argument("Invalid image metadata or missing buffer!");
     }
 
-    std::cout << "Gaussian filtering started" <<std::endl;
+    return applyGaussianFilter(makeGrayscaleView(inputImage), kernelSize, sigma, engine);
+}
 
-    const uint8_t* buffer = inputImage.buffer->data();
+std::vector<uint8_t> applyGaussianFilter(const ImageView& input, int kernelSize, double sigma, GaussianEngine engine) {
+    std::vector<uint8_t> outputBuffer(static_cast<size_t>(input.width) * input.height);
+    applyGaussianFilter(input, makeImageView(outputBuffer.data(), input.width, input.height), kernelSize, sigma, engine);
+    return outputBuffer;
+}
 
-    std::cout << "Buffer data collected" <<std::endl;
+void applyGaussianFilter(const ImageView& input, const MutableImageView& output, int kernelSize, double sigma,
+                         GaussianEngine engine) {
+    if (!input.isValid() || input.channels != 1) {
+        throw std::invalid_argument("Gaussian filter needs a valid single-channel view!");
+    }
+    requireSameSize(input, output);
 
-    const ImageMetadata& meta = inputImage.meta;
+    std::cout << "Gaussian filtering started" <<std::endl;
 
-    std::cout << "Meta data collected" <<std::endl;
+    if (engine == GaussianEngine::RECURSIVE) {
+        Image<float> smoothed(input.width, input.height);
+        recursiveGaussianFilter(input, smoothed.view(), sigma);
+
+        // Rounded like the vertical pass of the separable engine
+        parallelRowRanges(input.height, 64, [&](int rowBegin, int rowEnd) {
+            for (int r = rowBegin; r < rowEnd; ++r) {
+                const float* source = std::as_const(smoothed).view().row(r);
+                uint8_t* destination = output.row(r);
+                for (int j = 0; j < input.width; ++j) {
+                    destination[j] = static_cast<uint8_t>(std::clamp(source[j], 0.0f, 255.0f));
+                }
+            }
+        });
+
+        std::cout << "Applying Gaussian Filter is completed" <<std::endl;
+        return;
+    }
 
-    int rows = meta.height;
-    int cols = meta.width;
     int halfKernel = kernelSize / 2;
 
-    // Create an output buffer initialized to zero
-    std::vector<uint8_t> outputBuffer(rows * cols, 0);
+    // Create a normalized 1D Gaussian kernel (the 2D kernel is its outer product)
+    std::vector<float> kernel = createGaussianKernel1D(halfKernel, sigma);
+
+    std::cout << "Gaussian kernel created" <<std::endl;
+
+    // Apply the Gaussian filter: horizontal pass, then vertical pass, one row band at a time
+    parallelRowBands(input, output, halfKernel, [&kernel](const ImageView& band, const MutableImageView& bandOutput) {
+        // Intermediate result of the horizontal pass, kept in float so the vertical pass sees unrounded values
+        Image<float> temp(band.width, band.height);
+
+        convolveRowsGaussian(band, temp.view(), kernel);
+        convolveColumnsGaussianTo(std::as_const(temp).view(), bandOutput, kernel);
+    });
+
+    std::cout << "Applying Gaussian Filter is completed" <<std::endl;
+}
+
+
+// Median Filter --------------------------------------------------------------------------------------
+
+/* Two engines compute the same result (the element at index n/2 of the sorted in-bounds window):
+ *
+ *  SORTING   - collects the window and runs std::nth_element. O(k^2) per pixel; kept as the reference path.
+ *  HISTOGRAM - Perreault-Hebert: one 256-bin histogram per column covering the vertical window, updated
+ *              with one add and one remove per row, and a kernel histogram that slides horizontally by
+ *              adding the entering column histogram and subtracting the leaving one. A 16-bin coarse level
+ *              (value >> 4) narrows the median search to 16 + 16 steps. Cost per pixel does not depend on k.
+ */
+
+namespace {
+
+constexpr int MEDIAN_BINS = 256;
+constexpr int MEDIAN_COARSE_BINS = 16;
+
+void medianFilterSorting(const ImageView& input, const MutableImageView& output, int halfKernel) {
+    const int rows = input.height;
+    const int cols = input.width;
 
     // Temporary vector to store the kernel values for median calculation
     std::vector<uint8_t> window;
 
-    // Apply the median filter
     for (int i = 0; i < rows; ++i) {
         for (int j = 0; j < cols; ++j) {
             window.clear();
@@ -165,23 +608,154 @@ std::vector<uint8_t> applyMedianFilter(const ImageReadResult& inputImage, int ke
 
                     // Ensure the indices are within bounds
                     if (x >= 0 && x < rows && y >= 0 && y < cols) {
-                        window.push_back(buffer[x * cols + y]);
+                        window.push_back(input.row(x)[y]);
                     }
                 }
             }
 
             // Find the median value
             std::nth_element(window.begin(), window.begin() + window.size() / 2, window.end());
-            uint8_t median = window[window.size() / 2];
+            output.row(i)[j] = window[window.size() / 2];
+        }
+    }
+}
 
-            // Assign the median to the output buffer
-            outputBuffer[i * cols + j] = median;
+// dst += add (bins entries)
+template <typename CountT, int Bins>
+inline void addHistogram(CountT* dst, const CountT* add) {
+    for (int b = 0; b < Bins; ++b) dst[b] += add[b];
+}
+
+// dst -= sub (bins entries)
+template <typename CountT, int Bins>
+inline void subtractHistogram(CountT* dst, const CountT* sub) {
+    for (int b = 0; b < Bins; ++b) dst[b] -= sub[b];
+}
+
+// CountT must hold the largest window population: uint16_t covers kernels up to 255 x 255
+template <typename CountT>
+void medianFilterHistogram(const ImageView& input, const MutableImageView& output, int halfKernel) {
+    const int rows = input.height;
+    const int cols = input.width;
+
+    std::vector<CountT> columnFine(static_cast<size_t>(cols) * MEDIAN_BINS, 0);
+    std::vector<CountT> columnCoarse(static_cast<size_t>(cols) * MEDIAN_COARSE_BINS, 0);
+
+    auto addRow = [&](int x) {
+        const uint8_t* src = input.row(x);
+        for (int j = 0; j < cols; ++j) {
+            columnFine[static_cast<size_t>(j) * MEDIAN_BINS + src[j]]++;
+            columnCoarse[static_cast<size_t>(j) * MEDIAN_COARSE_BINS + (src[j] >> 4)]++;
         }
+    };
+    auto removeRow = [&](int x) {
+        const uint8_t* src = input.row(x);
+        for (int j = 0; j < cols; ++j) {
+            columnFine[static_cast<size_t>(j) * MEDIAN_BINS + src[j]]--;
+            columnCoarse[static_cast<size_t>(j) * MEDIAN_COARSE_BINS + (src[j] >> 4)]--;
+        }
+    };
+
+    // Column histograms start out covering rows [0, halfKernel]
+    for (int x = 0; x <= std::min(halfKernel, rows - 1); ++x) {
+        addRow(x);
     }
 
+    alignas(64) CountT kernelFine[MEDIAN_BINS];
+    alignas(64) CountT kernelCoarse[MEDIAN_COARSE_BINS];
+
+    for (int i = 0; i < rows; ++i) {
+        if (i > 0) {
+            if (i + halfKernel < rows)  addRow(i + halfKernel);
+            if (i - halfKernel - 1 >= 0) removeRow(i - halfKernel - 1);
+        }
+
+        int rowCount = std::min(i + halfKernel, rows - 1) - std::max(i - halfKernel, 0) + 1;
+
+        // Kernel histogram for j = 0 covers columns [0, halfKernel]
+        std::fill(kernelFine, kernelFine + MEDIAN_BINS, CountT(0));
+        std::fill(kernelCoarse, kernelCoarse + MEDIAN_COARSE_BINS, CountT(0));
+        for (int y = 0; y <= std::min(halfKernel, cols - 1); ++y) {
+            addHistogram<CountT, MEDIAN_BINS>(kernelFine, &columnFine[static_cast<size_t>(y) * MEDIAN_BINS]);
+            addHistogram<CountT, MEDIAN_COARSE_BINS>(kernelCoarse, &columnCoarse[static_cast<size_t>(y) * MEDIAN_COARSE_BINS]);
+        }
+
+        uint8_t* dst = output.row(i);
+        for (int j = 0; j < cols; ++j) {
+            if (j > 0) {
+                int enteringCol = j + halfKernel;
+                int leavingCol = j - halfKernel - 1;
+                if (enteringCol < cols) {
+                    addHistogram<CountT, MEDIAN_BINS>(kernelFine, &columnFine[static_cast<size_t>(enteringCol) * MEDIAN_BINS]);
+                    addHistogram<CountT, MEDIAN_COARSE_BINS>(kernelCoarse, &columnCoarse[static_cast<size_t>(enteringCol) * MEDIAN_COARSE_BINS]);
+                }
+                if (leavingCol >= 0) {
+                    subtractHistogram<CountT, MEDIAN_BINS>(kernelFine, &columnFine[static_cast<size_t>(leavingCol) * MEDIAN_BINS]);
+                    subtractHistogram<CountT, MEDIAN_COARSE_BINS>(kernelCoarse, &columnCoarse[static_cast<size_t>(leavingCol) * MEDIAN_COARSE_BINS]);
+                }
+            }
+
+            int colCount = std::min(j + halfKernel, cols - 1) - std::max(j - halfKernel, 0) + 1;
+
+            // Same element nth_element would pick: rank n/2 of the sorted window
+            uint32_t rank = static_cast<uint32_t>(rowCount) * colCount / 2;
+
+            // Coarse search, then fine search inside the selected group of 16 bins
+            uint32_t accumulated = 0;
+            int coarse = 0;
+            while (accumulated + kernelCoarse[coarse] <= rank) {
+                accumulated += kernelCoarse[coarse];
+                ++coarse;
+            }
+            int value = coarse * 16;
+            while (accumulated + kernelFine[value] <= rank) {
+                accumulated += kernelFine[value];
+                ++value;
+            }
+
+            dst[j] = static_cast<uint8_t>(value);
+        }
+    }
+}
+
+} // namespace
+
+std::vector<uint8_t> applyMedianFilter(const ImageReadResult& inputImage, int kernelSize, MedianEngine engine) {
+    if (!inputImage.meta.isValid() || !inputImage.buffer.has_value()) {
+        throw std::invalid_argument("Invalid image metadata or missing buffer!");
+    }
+
+    return applyMedianFilter(makeGrayscaleView(inputImage), kernelSize, engine);
+}
+
+std::vector<uint8_t> applyMedianFilter(const ImageView& input, int kernelSize, MedianEngine engine) {
+    std::vector<uint8_t> outputBuffer(static_cast<size_t>(input.width) * input.height);
+    applyMedianFilter(input, makeImageView(outputBuffer.data(), input.width, input.height), kernelSize, engine);
     return outputBuffer;
 }
 
+void applyMedianFilter(const ImageView& input, const MutableImageView& output, int kernelSize, MedianEngine engine) {
+    if (!input.isValid() || input.channels != 1) {
+        throw std::invalid_argument("Median filter needs a valid single-channel view!");
+    }
+    requireSameSize(input, output);
+
+    std::cout << "Median filtering started" <<std::endl;
+
+    int halfKernel = kernelSize / 2;
+
+    parallelRowBands(input, output, halfKernel, [engine, halfKernel](const ImageView& band, const MutableImageView& bandOutput) {
+        // Apply the median filter
+        if (engine == MedianEngine::SORTING) {
+            medianFilterSorting(band, bandOutput, halfKernel);
+        } else if (2 * halfKernel + 1 <= 255) {
+            medianFilterHistogram<uint16_t>(band, bandOutput, halfKernel);
+        } else {
+            medianFilterHistogram<uint32_t>(band, bandOutput, halfKernel);
+        }
+    });
+}
+
 // Perform lowpass filter using the above lowpass filter functions based on user input -----------------------------
 
 std::vector<uint8_t> lowPassFilter(const ImageReadResult &inputImage) {
@@ -191,20 +765,37 @@ std::vector<uint8_t> lowPassFilter(const ImageReadResult &inputImage) {
                     << "1. Box filter\n"
                     << "2. Gaussian filter\n"
                     << "3. Median filter\n"
+                    << "4. Recursive Gaussian filter (any sigma, same cost)\n"
                     << "Type the number: ";
 
     std::cin >> kernelChoice;
     std::cout << std::endl;
 
-    int kernelSize;
-    std::cout << "Enter the size of the kernel: ";
-    std::cin >> kernelSize;
-    std::cout << std::endl;
+    int kernelSize = 0;
+    if (kernelChoice != 4)
+    {
+        std::cout << "Enter the size of the kernel: ";
+        std::cin >> kernelSize;
+        std::cout << std::endl;
+    }
+
+    double sigma = 1.0;
+    if (kernelChoice == 2 || kernelChoice == 4)
+    {
+        std::cout << "Enter the sigma value: ";
+        std::cin >> sigma;
+        std::cout << std::endl;
+    }
+
+    return lowPassFilter(inputImage, kernelChoice, kernelSize, sigma);
+}
+
+std::vector<uint8_t> lowPassFilter(const ImageReadResult &inputImage, int kernelChoice, int kernelSize, double sigma) {
 
     // create a buffer to store filtered result
     std::vector<uint8_t> filteredBuffer;
 
-    // User choices for kernel: 1. Box 2. Gaussian 3. Median
+    // User choices for kernel: 1. Box 2. Gaussian 3. Median 4. Recursive Gaussian
 
     if (kernelChoice == 1)
     {
@@ -214,21 +805,22 @@ std::vector<uint8_t> lowPassFilter(const ImageReadResult &inputImage) {
 
     } else if (kernelChoice == 2)
     {
-        std::cout << "Enter the sigma value: ";
-        double sigma;
-        std::cin >> sigma;
-        std::cout << std::endl;
-
         std::cout << "Gaussian filter started with kernelsize " << kernelSize << "and sigma " << sigma << " . . ." << std::endl;
 
         filteredBuffer = applyGaussianFilter(inputImage, kernelSize, sigma);
 
     }else if (kernelChoice == 3)
     {
-        std::cout << "Box filter started with kernel size " << kernelSize << " . . ." << std::endl;
+        std::cout << "Median filter started with kernel size " << kernelSize << " . . ." << std::endl;
 
         filteredBuffer = applyMedianFilter(inputImage, kernelSize);
 
+    }else if (kernelChoice == 4)
+    {
+        std::cout << "Recursive Gaussian filter started with sigma " << sigma << " . . ." << std::endl;
+
+        filteredBuffer = applyGaussianFilter(inputImage, kernelSize, sigma, GaussianEngine::RECURSIVE);
+
     }
 
     return filteredBuffer;
@@ -242,78 +834,68 @@ std::vector<uint8_t> applyHighPassFilter(const ImageReadResult& inputImage, int
         throw std::invalid_argument("Invalid image metadata or missing buffer!");
     }
 
-    const uint8_t* buffer = inputImage.buffer->data();
-    const ImageMetadata& meta = inputImage.meta;
-
-    int rows = meta.height;
-    int cols = meta.width;
-
     // Define the kernels
-    int basicLaplacian[3][3] = {
+    static const Kernel3x3 basicLaplacian = {{
         {0,  1,  0},
         {1, -4,  1},
         {0,  1,  0}
-    };
+    }};
 
-    int fullLaplacian[3][3] = {
+    static const Kernel3x3 fullLaplacian = {{
         {1,  1,  1},
         {1, -8,  1},
         {1,  1,  1}
-    };
+    }};
 
-    int basicInvertedLaplacian[3][3] = {
+    static const Kernel3x3 basicInvertedLaplacian = {{
         {0,  -1,  0},
         {-1,  4, -1},
         {0,  -1,  0}
-    };
+    }};
 
-    int fullInvertedLaplacian[3][3] = {
+    static const Kernel3x3 fullInvertedLaplacian = {{
         {-1, -1, -1},
         {-1,  8, -1},
         {-1, -1, -1}
-    };
+    }};
 
-    int sobelOperator[3][3] = {
+    static const Kernel3x3 sobelOperator = {{
         {-1, -2, -1},
         {0, 0, 0},
         {1, 2, 1}
-    };
+    }};
 
     // Select the kernel based on user choice
-    int (*selectedKernel)[3] = nullptr;
+    const Kernel3x3* selectedKernel = nullptr;
 
     switch (kernelChoice) {
-        case 1: selectedKernel = basicLaplacian;            std::cout << "Applying Basic Laplacian"             <<std::endl; break;
-        case 2: selectedKernel = fullLaplacian;             std::cout << "Applying Full Laplacian"              <<std::endl; break;
-        case 3: selectedKernel = basicInvertedLaplacian;    std::cout << "Applying Basic Inverted Laplacian"    <<std::endl; break;
-        case 4: selectedKernel = fullInvertedLaplacian;     std::cout << "Applying Full Inverted Laplacian"     <<std::endl; break;
-        case 5: selectedKernel = sobelOperator;             std::cout << "Applying Sobel Operator"              <<std::endl; break;
+        case 1: selectedKernel = &basicLaplacian;            std::cout << "Applying Basic Laplacian"             <<std::endl; break;
+        case 2: selectedKernel = &fullLaplacian;             std::cout << "Applying Full Laplacian"              <<std::endl; break;
+        case 3: selectedKernel = &basicInvertedLaplacian;    std::cout << "Applying Basic Inverted Laplacian"    <<std::endl; break;
+        case 4: selectedKernel = &fullInvertedLaplacian;     std::cout << "Applying Full Inverted Laplacian"     <<std::endl; break;
+        case 5: selectedKernel = &sobelOperator;             std::cout << "Applying Sobel Operator"              <<std::endl; break;
         default:
             throw std::invalid_argument("Invalid kernel choice! Type a valid number");
     }
 
-    // Create an output buffer initialized to zero
-    std::vector<uint8_t> outputBuffer(rows * cols, 0);
+    // Apply the selected high-pass filter kernel, one row band at a time (rows of a band are contiguous)
+    ImageView input = makeGrayscaleView(inputImage);
+    std::vector<uint8_t> outputBuffer(static_cast<size_t>(input.width) * input.height);
 
-    // Apply the selected high-pass filter kernel
-    for (int i = 1; i < rows - 1; ++i) { // Skip the edges
-        for (int j = 1; j < cols - 1; ++j) {
-            int sum = 0;
+    parallelRowBands(input, makeImageView(outputBuffer.data(), input.width, input.height), 1,
+                     [selectedKernel](const ImageView& band, const MutableImageView& bandOutput) {
+        int rows = band.height;
+        int cols = band.width;
 
-            // Convolve the selected kernel
-            for (int ki = -1; ki <= 1; ++ki) {
-                for (int kj = -1; kj <= 1; ++kj) {
-                    int x = i + ki;
-                    int y = j + kj;
-                    sum += buffer[x * cols + y] * selectedKernel[ki + 1][kj + 1];
-                }
-            }
-
-            // Clamp the output value to 0-255
-            outputBuffer[i * cols + j] = std::clamp(sum, 0, 255);
+        // The edges stay zero; the engine clamps the sums to 0-255
+        for (int i = 0; i < rows; ++i) {
+            std::fill(bandOutput.row(i), bandOutput.row(i) + cols, 0);
         }
-    }
-
+        for (int i = 1; i < rows - 1; ++i) {
+            const uint8_t* window[3] = {band.row(i - 1), band.row(i), band.row(i + 1)};
+            convolveRow3x3Saturate(window, cols - 2, *selectedKernel, bandOutput.row(i) + 1);
+        }
+    });
     return outputBuffer;
 }
 
@@ -351,26 +933,43 @@ std::vector<uint8_t> applyImageSharpening(const ImageReadResult& inputImage, int
 
 }
 
-std::vector<uint8_t> applyUMHBF(const ImageReadResult& inputImage, double k) {
-    /* UMHBF = Unsharp Maksing and Highboost Filtering
-     * 
-     * if k > 1; Highboost filtering
-     * if k < 1; Unsharp masking
-     * 
-     */
+namespace {
+
+std::vector<uint8_t> combineWithBlurred(const ImageReadResult& inputImage, const std::vector<uint8_t>& filteredBuffer, double k) {
     int rows = inputImage.meta.height;
     int cols = inputImage.meta.width;
 
-    std::vector<uint8_t> filteredBuffer;
     std::vector<uint8_t> umhbfBuffer(rows * cols, 0);
     const uint8_t* buffer = inputImage.buffer->data();
 
-    filteredBuffer = lowPassFilter(inputImage);
-
     for (int i = 0; i < rows * cols; ++i) {
         int maskedValue = static_cast<int>(buffer[i]) + k * static_cast<int>(filteredBuffer[i]);
         umhbfBuffer[i] = std::clamp(maskedValue, 0, 255);  // Clamp to valid range
     }
 
     return umhbfBuffer;
-}
\ No newline at end of file
+}
+
+} // namespace
+
+std::vector<uint8_t> applyUMHBF(const ImageReadResult& inputImage, double k) {
+    /* UMHBF = Unsharp Maksing and Highboost Filtering
+     * 
+     * if k > 1; Highboost filtering
+     * if k < 1; Unsharp masking
+     * 
+     */
+    std::vector<uint8_t> filteredBuffer = lowPassFilter(inputImage);
+    if (filteredBuffer.empty()) {
+        throw std::invalid_argument("Unknown lowpass filter choice!");
+    }
+    return combineWithBlurred(inputImage, filteredBuffer, k);
+}
+
+std::vector<uint8_t> applyUMHBF(const ImageReadResult& inputImage, double k, int kernelChoice, int kernelSize, double sigma) {
+    std::vector<uint8_t> filteredBuffer = lowPassFilter(inputImage, kernelChoice, kernelSize, sigma);
+    if (filteredBuffer.empty()) {
+        throw std::invalid_argument("Unknown lowpass filter choice!");
+    }
+    return combineWithBlurred(inputImage, filteredBuffer, k);
+}
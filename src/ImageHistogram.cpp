@@ -1,32 +1,147 @@
 #include "ImageHistogram.h"
+#include "MappedImage.h"
+#include "ThreadPool.h"
+#include <mutex>
+#include <stdexcept>
 #include <iostream>
 #include <fstream>
 #include <numeric>
 #include <algorithm>
 #include <math.h>
 
-void calculateHistogram(const ImageReadResult &result, std::vector<int> &histogram, int channel) {
+// Histogram engine ----
+
+/* Incrementing one shared counter per sample stalls whenever the same value repeats (flat regions, dark
+ * backgrounds): each increment has to wait for the store of the previous one to the same counter.
+ * Consecutive samples of a channel therefore go to several interleaved sub-histograms, which are
+ * summed at the end. The sub-histograms use 32-bit counters to stay small enough for L1 and are
+ * flushed into 64-bit totals long before they could overflow. Every channel of an interleaved image is
+ * counted in the same pass, and row ranges are counted in parallel and merged.
+ */
+
+namespace {
+
+// Channels == 0: channel count only known at run time. Grayscale rows get more copies, since there every
+// sample goes to the same channel histogram.
+template <int Channels, int Copies = (Channels == 1) ? 8 : 4>
+void countRows(const ImageView& view, int rowBegin, int rowEnd, std::vector<std::vector<uint64_t>>& totals) {
+    const int channels = (Channels > 0) ? Channels : view.channels;
+    const int width = view.width;
+    const size_t copyBins = static_cast<size_t>(channels) * NUM_BINS_8BIT;
+
+    // counts[(copy * channels + channel) * 256 + value]
+    std::vector<uint32_t> counts(Copies * copyBins, 0);
+    uint64_t samplesSinceFlush = 0;
+
+    auto flush = [&]() {
+        for (int c = 0; c < channels; ++c) {
+            for (int v = 0; v < NUM_BINS_8BIT; ++v) {
+                uint64_t sum = 0;
+                for (int copy = 0; copy < Copies; ++copy) {
+                    sum += counts[copy * copyBins + c * NUM_BINS_8BIT + v];
+                }
+                totals[c][v] += sum;
+            }
+        }
+        std::fill(counts.begin(), counts.end(), 0);
+        samplesSinceFlush = 0;
+    };
+
+    uint32_t* base = counts.data();
+    for (int r = rowBegin; r < rowEnd; ++r) {
+        if (samplesSinceFlush + width > UINT32_MAX) {
+            flush();
+        }
+        samplesSinceFlush += width;
+
+        const uint8_t* row = view.row(r);
+        int j = 0;
+        for (; j + Copies <= width; j += Copies) {
+            const uint8_t* pixels = row + static_cast<size_t>(j) * channels;
+            for (int copy = 0; copy < Copies; ++copy) {
+                for (int c = 0; c < channels; ++c) {
+                    base[copy * copyBins + c * NUM_BINS_8BIT + pixels[copy * channels + c]]++;
+                }
+            }
+        }
+        for (; j < width; ++j) {
+            const uint8_t* pixel = row + static_cast<size_t>(j) * channels;
+            for (int c = 0; c < channels; ++c) {
+                base[c * NUM_BINS_8BIT + pixel[c]]++;
+            }
+        }
+    }
+    flush();
+}
+
+} // namespace
+
+std::vector<std::vector<uint64_t>> computeChannelHistograms(const ImageView& view) {
+    if (!view.isValid()) {
+        throw std::invalid_argument("Histogram needs a valid view!");
+    }
+
+    std::vector<std::vector<uint64_t>> histograms(view.channels, std::vector<uint64_t>(NUM_BINS_8BIT, 0));
+    std::mutex mergeMutex;
+
+    parallelRowRanges(view.height, 64, [&](int rowBegin, int rowEnd) {
+        std::vector<std::vector<uint64_t>> local(view.channels, std::vector<uint64_t>(NUM_BINS_8BIT, 0));
+        switch (view.channels) {
+            case 1:  countRows<1>(view, rowBegin, rowEnd, local); break;
+            case 3:  countRows<3>(view, rowBegin, rowEnd, local); break;
+            default: countRows<0>(view, rowBegin, rowEnd, local); break;
+        }
+
+        std::lock_guard<std::mutex> lock(mergeMutex);
+        for (int c = 0; c < view.channels; ++c) {
+            for (int v = 0; v < NUM_BINS_8BIT; ++v) {
+                histograms[c][v] += local[c][v];
+            }
+        }
+    });
+
+    return histograms;
+}
+
+std::vector<uint64_t> computeHistogram(const ImageView& view) {
+    if (view.channels != 1) {
+        throw std::invalid_argument("computeHistogram needs a single-channel view; use computeChannelHistograms");
+    }
+    return std::move(computeChannelHistograms(view)[0]);
+}
+
+void calculateHistogram(const ImageReadResult &result, std::vector<uint64_t> &histogram, int channel) {
 
     const ImageMetadata &meta = result.meta;
     const uint8_t *buffer = result.buffer->data();
 
-    int numBins = (meta.bitDepth <= 8) ? NUM_BINS_8BIT : NUM_BINS_16BIT;
-    histogram.assign(numBins, 0); // Reset the histogram
+    if (meta.bitDepth == 16) {
+        histogram.assign(NUM_BINS_16BIT, 0);
+        const uint16_t *buffer16 = reinterpret_cast<const uint16_t *>(buffer);
+        for (size_t i = 0; i < static_cast<size_t>(meta.width) * meta.height; ++i) {
+            histogram[buffer16[i]]++;
+        }
+        return;
+    }
 
-    int stride = (channel == -1) ? 1 : 3;
-    int totalPixels = meta.width * meta.height;
+    int channels = std::max(1, meta.bitDepth / 8);
+    std::vector<std::vector<uint64_t>> histograms = computeChannelHistograms(makeImageView(buffer, meta.width, meta.height, channels));
 
-    for (int i = (channel == -1 ? 0 : channel); i < totalPixels * stride; i += stride) {
-        if (meta.bitDepth == 8) {
-            histogram[buffer[i]]++;
-        } else if (meta.bitDepth == 16) {
-            const uint16_t *buffer16 = reinterpret_cast<const uint16_t *>(buffer);
-            histogram[buffer16[i]]++;
+    if (channel >= 0) {
+        histogram = std::move(histograms.at(channel));
+        return;
+    }
+
+    // All samples of all channels
+    histogram.assign(NUM_BINS_8BIT, 0);
+    for (const std::vector<uint64_t> &channelHistogram : histograms) {
+        for (int v = 0; v < NUM_BINS_8BIT; ++v) {
+            histogram[v] += channelHistogram[v];
         }
     }
 }
 
-void displayHistogram(const std::vector<int> &histogram, int bitDepth, bool isColor, char channelName) {
+void displayHistogram(const std::vector<uint64_t> &histogram, int bitDepth, bool isColor, char channelName) {
     if (isColor) {
         std::cout << "Histogram for channel: " << channelName << "\n";
     } else {
@@ -41,7 +156,7 @@ void displayHistogram(const std::vector<int> &histogram, int bitDepth, bool isCo
     }
 }
 
-void saveHistogramToFile(const std::vector<int> &histogram, const std::string &fileName) {
+void saveHistogramToFile(const std::vector<uint64_t> &histogram, const std::string &fileName) {
     std::ofstream outFile(fileName);
     if (!outFile) {
         std::cerr << "Error: Unable to open file for writing: " << fileName << "\n";
@@ -58,21 +173,21 @@ void saveHistogramToFile(const std::vector<int> &histogram, const std::string &f
     std::cout << "Histogram data saved to " << fileName << "\n";
 }
 
-void displayHistogramAsBarChart(const std::vector<int> &histogram) {
-    int maxFrequency = *std::max_element(histogram.begin(), histogram.end());
+void displayHistogramAsBarChart(const std::vector<uint64_t> &histogram) {
+    uint64_t maxFrequency = *std::max_element(histogram.begin(), histogram.end());
 
     std::cout << "Histogram (Bar Chart):\n";
     for (size_t i = 0; i < histogram.size(); ++i) {
         if (histogram[i] > 0) {
             std::cout << i << ": ";
-            int barLength = (50 * histogram[i]) / maxFrequency; // Scale to 50 characters
+            size_t barLength = (50 * histogram[i]) / maxFrequency; // Scale to 50 characters
             std::cout << std::string(barLength, '#') << " (" << histogram[i] << ")\n";
         }
     }
 }
 
 void grayscaleHistogram(const ImageReadResult &result) {
-    std::vector<int> histogram(NUM_BINS_8BIT);
+    std::vector<uint64_t> histogram;
     calculateHistogram(result, histogram);
     displayHistogram(histogram, result.meta.bitDepth, false, 'N');
     saveHistogramToFile(histogram, "histogram_data.csv");
@@ -85,13 +200,13 @@ void rgbHistogram(const ImageReadResult &result) {
         return;
     }
 
-    std::vector<int> redHistogram(NUM_BINS_8BIT);
-    std::vector<int> greenHistogram(NUM_BINS_8BIT);
-    std::vector<int> blueHistogram(NUM_BINS_8BIT);
-
-    calculateHistogram(result, redHistogram, 0);
-    calculateHistogram(result, greenHistogram, 1);
-    calculateHistogram(result, blueHistogram, 2);
+    // One pass over the pixels for all three channels; BMP stores them as B, G, R
+    const ImageMetadata &meta = result.meta;
+    std::vector<std::vector<uint64_t>> histograms =
+        computeChannelHistograms(makeImageView(result.buffer->data(), meta.width, meta.height, 3));
+    const std::vector<uint64_t> &blueHistogram = histograms[0];
+    const std::vector<uint64_t> &greenHistogram = histograms[1];
+    const std::vector<uint64_t> &redHistogram = histograms[2];
 
     displayHistogram(redHistogram, 8, true, 'R');
     displayHistogram(greenHistogram, 8, true, 'G');
@@ -117,31 +232,31 @@ void rgbHistogram(const ImageReadResult &result) {
 
 */
 
-std::vector<uint8_t> histogramEqualization(const ImageReadResult &result) {
+namespace {
 
-    std::cout << "Performin histogram equalization...";
-    const auto &meta = result.meta;
-    size_t totalPixels = meta.width * meta.height;
+// std::round for 0 <= value < 2^23 without the library call; CLAHE builds thousands of tables per image
+inline int roundNonNegative(float value) {
+    int truncated = static_cast<int>(value);
+    return truncated + (value - truncated >= 0.5f ? 1 : 0);
+}
 
-    const uint8_t       *buffer = result.buffer->data();
-    std::vector<uint8_t> equalizedBuffer(totalPixels);
+} // namespace
 
-    for (size_t i = 0; i < totalPixels; ++i) {
-        if (buffer[i] < 0 || buffer[i] > 255) {
-            throw std::runtime_error("Buffer contains invalid pixel value at index " + std::to_string(i));
-        }
+LookupTable equalizationTable(const std::vector<uint64_t> &histogram) {
+    uint64_t totalPixels = 0;
+    for (uint64_t count : histogram) {
+        totalPixels += count;
     }
-
-    // Step 1: Compute the histogram
-    int histogram[256] = {0};
-    for (size_t i = 0; i < totalPixels; ++i) {
-        histogram[buffer[i]]++;
+    if (totalPixels == 0) {
+        return LookupTable::identity();   // empty histogram: nothing to stretch
     }
 
     // Step 2: Compute the normalized histogram
+    // (counts go through int64_t: same value, but a single instruction where uint64_t -> float is a branch)
     float normalizedHistogram[256] = {0.0f};
+    const float totalSamples = static_cast<float>(static_cast<int64_t>(totalPixels));
     for (int i = 0; i < 256; ++i) {
-        normalizedHistogram[i] = static_cast<float>(histogram[i]) / totalPixels;
+        normalizedHistogram[i] = static_cast<float>(static_cast<int64_t>(histogram[i])) / totalSamples;
     }
 
     // Step 3: Compute the cumulative distribution function (CDF)
@@ -152,21 +267,364 @@ std::vector<uint8_t> histogramEqualization(const ImageReadResult &result) {
     }
 
     // Step 4: Compute the lookup table
-    uint8_t lookupTable[256];
+    LookupTable lookupTable;
     float cdfMin = cdf[0]; // Smallest non-zero CDF value
+    if (cdfMin >= 1.0f) {
+        return LookupTable::identity();   // every sample is 0: nothing to stretch
+    }
     for (int i = 0; i < 256; ++i) {
-        lookupTable[i] = static_cast<uint8_t>(std::round((cdf[i] - cdfMin) / (1.0f - cdfMin) * 255));
+        lookupTable.values[i] = static_cast<uint8_t>(roundNonNegative((cdf[i] - cdfMin) / (1.0f - cdfMin) * 255));
     }
 
-    // Step 5: Map the original image to the equalized image
+    return lookupTable;
+}
 
-    for (size_t i = 0; i < totalPixels; ++i) {
-        equalizedBuffer[i] = lookupTable[buffer[i]];
-    }
+std::vector<uint8_t> histogramEqualization(const ImageReadResult &result) {
+
+    std::cout << "Performin histogram equalization...";
+    const auto &meta = result.meta;
+    size_t totalPixels = meta.width * meta.height;
+
+    const uint8_t       *buffer = result.buffer->data();
+    std::vector<uint8_t> equalizedBuffer(totalPixels);
+
+    // Step 1: Compute the histogram
+    std::vector<uint64_t> histogram = computeHistogram(makeGrayscaleView(result));
+
+    // Steps 2-4: the equalization mapping as a lookup table
+    LookupTable lookupTable = equalizationTable(histogram);
+
+    // Step 5: Map the original image to the equalized image
+    applyLookupTable(lookupTable, buffer, equalizedBuffer.data(), totalPixels);
 
     std::cout << "Histogram equalization completed";
 
     return equalizedBuffer;
 }
 
+// Histogram Specification ----
+
+std::vector<uint64_t> loadHistogramFromFile(const std::string &fileName) {
+    std::ifstream inFile(fileName);
+    if (!inFile) {
+        throw std::invalid_argument("Unable to open histogram file: " + fileName);
+    }
+
+    std::vector<uint64_t> histogram(NUM_BINS_8BIT, 0);
+    std::string line;
+    std::getline(inFile, line);   // header
+    while (std::getline(inFile, line)) {
+        if (line.find_first_not_of(" \t\r") == std::string::npos) {
+            continue;
+        }
+
+        size_t comma = line.find(',');
+        unsigned long level = NUM_BINS_16BIT;
+        unsigned long long count = 0;
+        if (comma != std::string::npos) {
+            try {
+                level = std::stoul(line.substr(0, comma));
+                count = std::stoull(line.substr(comma + 1));
+            } catch (const std::exception &) {
+                level = NUM_BINS_16BIT;
+            }
+        }
+        if (level >= NUM_BINS_16BIT) {
+            throw std::invalid_argument("Malformed histogram line in " + fileName + ": " + line);
+        }
+
+        if (level >= histogram.size()) {
+            histogram.resize(NUM_BINS_16BIT, 0);
+        }
+        histogram[level] += count;
+    }
+    return histogram;
+}
+
+std::vector<uint64_t> loadReferenceHistogram(const std::string &path) {
+    if (path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0) {
+        return loadHistogramFromFile(path);
+    }
+
+    // mapImage has none of readImage's size limits and handles padded rows
+    ImageReadResult reference = mapImage(path).toImageReadResult();
+    if (!reference.buffer) {
+        throw std::invalid_argument("Unable to read reference image: " + path);
+    }
+    std::vector<uint64_t> histogram;
+    calculateHistogram(reference, histogram);
+    return histogram;
+}
+
+std::vector<double> cumulativeDistribution(const std::vector<uint64_t> &histogram) {
+    uint64_t total = std::accumulate(histogram.begin(), histogram.end(), uint64_t{0});
+    if (total == 0) {
+        throw std::invalid_argument("Cannot take the distribution of an empty histogram!");
+    }
+
+    std::vector<double> cdf(histogram.size());
+    uint64_t running = 0;
+    for (size_t i = 0; i < histogram.size(); ++i) {
+        running += histogram[i];
+        cdf[i] = static_cast<double>(running) / total;
+    }
+    return cdf;
+}
+
+std::vector<uint16_t> specificationMapping(const std::vector<uint64_t> &sourceHistogram, const std::vector<double> &referenceCdf) {
+    if (sourceHistogram.size() != referenceCdf.size()) {
+        throw std::invalid_argument("Reference histogram has " + std::to_string(referenceCdf.size()) +
+                                    " bins, the image needs " + std::to_string(sourceHistogram.size()));
+    }
+    std::vector<double> sourceCdf = cumulativeDistribution(sourceHistogram);
+
+    // Both CDFs are non-decreasing, so one merge-like walk finds every inverse
+    std::vector<uint16_t> mapping(sourceCdf.size());
+    size_t z = 0;
+    for (size_t v = 0; v < sourceCdf.size(); ++v) {
+        while (z + 1 < referenceCdf.size() && referenceCdf[z] < sourceCdf[v]) {
+            ++z;
+        }
+        mapping[v] = static_cast<uint16_t>(z);
+    }
+    return mapping;
+}
+
+LookupTable specificationTable(const std::vector<uint64_t> &sourceHistogram, const std::vector<double> &referenceCdf) {
+    if (sourceHistogram.size() != NUM_BINS_8BIT) {
+        throw std::invalid_argument("specificationTable needs a 256-bin histogram!");
+    }
+    std::vector<uint16_t> mapping = specificationMapping(sourceHistogram, referenceCdf);
+
+    LookupTable table;
+    std::copy(mapping.begin(), mapping.end(), table.values);
+    return table;
+}
+
+std::vector<uint8_t> histogramSpecification(const ImageReadResult &result, const std::vector<double> &referenceCdf) {
+    const ImageMetadata &meta = result.meta;
+    const uint8_t *buffer = result.buffer->data();
+    size_t samples = static_cast<size_t>(meta.width) * meta.height * std::max(1, meta.bitDepth / 8);
+
+    std::vector<uint64_t> histogram;
+    calculateHistogram(result, histogram);
+
+    if (meta.bitDepth == 16) {
+        std::vector<uint16_t> mapping = specificationMapping(histogram, referenceCdf);
+        size_t pixels = static_cast<size_t>(meta.width) * meta.height;
+        std::vector<uint8_t> matchedBuffer(pixels * sizeof(uint16_t));
+        const uint16_t *input = reinterpret_cast<const uint16_t *>(buffer);
+        uint16_t *output = reinterpret_cast<uint16_t *>(matchedBuffer.data());
+        for (size_t i = 0; i < pixels; ++i) {
+            output[i] = mapping[input[i]];
+        }
+        return matchedBuffer;
+    }
+
+    std::vector<uint8_t> matchedBuffer(samples);
+    applyLookupTable(specificationTable(histogram, referenceCdf), buffer, matchedBuffer.data(), samples);
+    return matchedBuffer;
+}
+
+// CLAHE ----
+
+namespace {
+
+// Clips every bin at clipLimit times the mean bin count and spreads the clipped counts over all bins
+void clipHistogram(std::vector<uint64_t> &histogram, uint64_t tilePixels, double clipLimit) {
+    if (clipLimit <= 0) {
+        return;
+    }
+
+    uint64_t limit = std::max<uint64_t>(1, static_cast<uint64_t>(clipLimit * tilePixels / NUM_BINS_8BIT));
+    uint64_t excess = 0;
+    for (uint64_t &count : histogram) {
+        if (count > limit) {
+            excess += count - limit;
+            count = limit;
+        }
+    }
+
+    uint64_t perBin = excess / NUM_BINS_8BIT;
+    uint64_t residual = excess % NUM_BINS_8BIT;
+    for (uint64_t &count : histogram) {
+        count += perBin;
+    }
+    // The remainder goes to evenly spaced bins
+    if (residual > 0) {
+        uint64_t step = std::max<uint64_t>(1, NUM_BINS_8BIT / residual);
+        for (uint64_t v = 0; v < NUM_BINS_8BIT && residual > 0; v += step, --residual) {
+            histogram[v]++;
+        }
+    }
+}
+
+int tileCount(int pixels, int tileSize) {
+    return (pixels + tileSize - 1) / tileSize;
+}
+
+// Position of pixel index i on the grid of tile centers, as floor() and a 0..256 weight towards the next center
+void gridPosition(int i, int tileSize, int &tile, int &weight) {
+    int twice = 2 * i + 1 - tileSize;   // 2 * tileSize * ((i + 0.5) / tileSize - 0.5)
+    int period = 2 * tileSize;
+    tile = (twice >= 0) ? twice / period : -((period - 1 - twice) / period);
+    weight = ((twice - tile * period) * 256 + tileSize) / period;
+}
+
+} // namespace
+
+std::vector<LookupTable> claheTileTables(const ImageView &view, int tileSize, double clipLimit) {
+    if (!view.isValid() || view.channels != 1) {
+        throw std::invalid_argument("CLAHE needs a valid single-channel view!");
+    }
+    if (tileSize <= 0 || clipLimit < 0) {
+        throw std::invalid_argument("CLAHE needs a positive tile size and a non-negative clip limit!");
+    }
 
+    int tileColumns = tileCount(view.width, tileSize);
+    int tileRows = tileCount(view.height, tileSize);
+    std::vector<LookupTable> tables(static_cast<size_t>(tileColumns) * tileRows);
+
+    // Ranges of tiles rather than single tiles, so small tiles do not pay for a task and a histogram each
+    parallelRowRanges(static_cast<int>(tables.size()), 16, [&](int first, int last) {
+        std::vector<std::vector<uint64_t>> histogram(1);
+        for (int index = first; index < last; ++index) {
+            int x = (index % tileColumns) * tileSize;
+            int y = (index / tileColumns) * tileSize;
+            ImageView tile = view.subview(x, y, std::min(tileSize, view.width - x), std::min(tileSize, view.height - y));
+
+            histogram[0].assign(NUM_BINS_8BIT, 0);
+            countRows<1>(tile, 0, tile.height, histogram);
+            clipHistogram(histogram[0], static_cast<uint64_t>(tile.width) * tile.height, clipLimit);
+            tables[index] = equalizationTable(histogram[0]);
+        }
+    });
+
+    return tables;
+}
+
+ClaheInterpolator::ClaheInterpolator(int width, int height, int tileSize)
+    : width_(width), tileSize_(tileSize),
+      tileColumns_(tileCount(width, tileSize)), tileRows_(tileCount(height, tileSize)),
+      rightWeights_(width, 0) {
+    if (width <= 0 || height <= 0 || tileSize <= 0) {
+        throw std::invalid_argument("CLAHE needs a non-empty image and a positive tile size!");
+    }
+
+    for (int x = 0; x < width; ++x) {
+        int left, weight;
+        gridPosition(x, tileSize, left, weight);
+        int right = left + 1;
+        if (left < 0 || left >= tileColumns_ - 1) {
+            left = right = std::clamp(left, 0, tileColumns_ - 1);   // outside the outermost centers
+            weight = 0;
+        }
+        rightWeights_[x] = static_cast<uint16_t>(weight);
+
+        if (segments_.empty() || segments_.back().leftTile != left || segments_.back().rightTile != right) {
+            segments_.push_back({x, x, left, right});
+        }
+        segments_.back().end = x + 1;
+    }
+}
+
+int ClaheInterpolator::upperTileRow(int row) const {
+    int tile, weight;
+    gridPosition(row, tileSize_, tile, weight);
+    return std::clamp(tile, 0, tileRows_ - 1);
+}
+
+namespace {
+
+// (upper * (256 - lowerWeight) + lower * lowerWeight) / 256, rounded; 16-bit arithmetic, so it vectorizes well
+LookupTable blendTables(const LookupTable &upper, const LookupTable &lower, int lowerWeight) {
+    if (lowerWeight == 0) {
+        return upper;
+    }
+    LookupTable blended;
+    const uint16_t upperWeight = static_cast<uint16_t>(256 - lowerWeight);
+    for (int v = 0; v < 256; ++v) {
+        blended.values[v] = static_cast<uint8_t>(
+            static_cast<uint16_t>(upper.values[v] * upperWeight + lower.values[v] * lowerWeight + 128) >> 8);
+    }
+    return blended;
+}
+
+} // namespace
+
+void ClaheInterpolator::mapRow(int row, const uint8_t *input, uint8_t *output,
+                               const LookupTable *upperTables, const LookupTable *lowerTables) const {
+    int upper, lowerWeight;
+    gridPosition(row, tileSize_, upper, lowerWeight);
+    if (upper < 0 || upper >= tileRows_ - 1) {
+        lowerWeight = 0;
+    }
+
+    // The vertical weight is the same along the row, so the upper and lower tables of a tile column are
+    // blended once per row. That leaves two lookups per pixel, done by the vectorized applyLookupTable a
+    // chunk at a time, and a horizontal blend in 16-bit arithmetic. Weights are out of 256.
+    constexpr int chunk = 256;
+    uint8_t left[chunk], right[chunk];
+
+    int leftTile = -1, rightTile = -1;
+    LookupTable leftTable, rightTable;
+    for (const Segment &segment : segments_) {
+        if (segment.leftTile != leftTile) {
+            leftTable = (segment.leftTile == rightTile)
+                ? rightTable
+                : blendTables(upperTables[segment.leftTile], lowerTables[segment.leftTile], lowerWeight);
+            leftTile = segment.leftTile;
+        }
+        if (segment.rightTile != rightTile) {
+            rightTable = (segment.rightTile == leftTile)
+                ? leftTable
+                : blendTables(upperTables[segment.rightTile], lowerTables[segment.rightTile], lowerWeight);
+            rightTile = segment.rightTile;
+        }
+
+        for (int begin = segment.begin; begin < segment.end; begin += chunk) {
+            int count = std::min(chunk, segment.end - begin);
+            applyLookupTable(leftTable, input + begin, left, count);
+            if (leftTile == rightTile) {
+                std::copy(left, left + count, output + begin);
+                continue;
+            }
+            applyLookupTable(rightTable, input + begin, right, count);
+
+            const uint16_t *rightWeights = rightWeights_.data() + begin;
+            for (int i = 0; i < count; ++i) {
+                uint16_t leftWeight = static_cast<uint16_t>(256 - rightWeights[i]);
+                output[begin + i] = static_cast<uint8_t>(
+                    static_cast<uint16_t>(left[i] * leftWeight + right[i] * rightWeights[i] + 128) >> 8);
+            }
+        }
+    }
+}
+
+void applyCLAHE(const ImageView &input, const MutableImageView &output, int tileSize, double clipLimit) {
+    requireSameSize(input, output);
+
+    // All tables first, so the mapping may overwrite the input
+    std::vector<LookupTable> tables = claheTileTables(input, tileSize, clipLimit);
+    ClaheInterpolator interpolator(input.width, input.height, tileSize);
+    const int tileColumns = interpolator.tileColumns();
+
+    parallelRowRanges(input.height, 64, [&](int rowBegin, int rowEnd) {
+        for (int r = rowBegin; r < rowEnd; ++r) {
+            interpolator.mapRow(r, input.row(r), output.row(r),
+                                &tables[static_cast<size_t>(interpolator.upperTileRow(r)) * tileColumns],
+                                &tables[static_cast<size_t>(interpolator.lowerTileRow(r)) * tileColumns]);
+        }
+    });
+}
+
+std::vector<uint8_t> applyCLAHE(const ImageReadResult &result, int tileSize, double clipLimit) {
+    if (result.meta.bitDepth != 8) {
+        throw std::invalid_argument("CLAHE is only supported for 8-bit grayscale images!");
+    }
+
+    const ImageMetadata &meta = result.meta;
+    std::vector<uint8_t> equalizedBuffer(static_cast<size_t>(meta.width) * meta.height);
+    applyCLAHE(makeGrayscaleView(result), makeImageView(equalizedBuffer.data(), meta.width, meta.height), tileSize, clipLimit);
+    return equalizedBuffer;
+}
@@ -1,89 +1,244 @@
 #include "ImageMorphology.h"
+#include "ThreadPool.h"
 #include <algorithm>
 #include <cassert>
+#include <stdexcept>
+#include <string>
+
+/* Erosion and dilation with a rectangular structuring element
+ *
+ * A min (or max) over a kernelRows x kernelColumns rectangle is a min over rows of a min over columns,
+ * so each op is a horizontal 1-D pass followed by a vertical 1-D pass. Each 1-D pass uses the
+ * van Herk/Gil-Werman algorithm: the line is padded with the identity element (255 for min, 0 for max),
+ * split into blocks of the window length w, and a prefix g and suffix h are computed inside each block.
+ * Any window of length w spans at most two blocks, so result[x] = op(h[x], g[x + w - 1]).
+ * That is 3 comparisons per pixel per pass regardless of the window size.
+ *
+ * Padding with the identity gives exactly the old clipped-window behaviour: out-of-bounds positions
+ * can never win the min/max.
+ */
+
+namespace {
+
+struct MinOp {
+    static constexpr uint8_t identity = 255;
+    static uint8_t apply(uint8_t a, uint8_t b) { return std::min(a, b); }
+};
+
+struct MaxOp {
+    static constexpr uint8_t identity = 0;
+    static uint8_t apply(uint8_t a, uint8_t b) { return std::max(a, b); }
+};
+
+// Padded line length: the line plus half a window on each side, rounded up to whole blocks
+int paddedLength(int length, int half) {
+    int window = 2 * half + 1;
+    int padded = length + 2 * half;
+    return ((padded + window - 1) / window) * window;
+}
 
-// Erosion
-std::vector<uint8_t> applyErosion(const ImageReadResult& inputImage, int kernelColumns, int kernelRows) {
-    const uint8_t* buffer = inputImage.buffer->data();
-    const ImageMetadata& meta = inputImage.meta;
+// 1-D min/max of width 2 * half + 1 along every row
+template <typename Op>
+void vanHerkGilWermanRows(const ImageView& src, uint8_t* dst, int half) {
+    const int rows = src.height;
+    const int cols = src.width;
+    const int window = 2 * half + 1;
+    const int length = paddedLength(cols, half);
 
-    int rows = meta.height;
-    int cols = meta.width;
-    int halfKernelColumns = kernelColumns / 2;
-    int halfKernelRows = kernelRows / 2;
-
-    std::vector<uint8_t> outputBuffer(rows * cols, 255);
+    std::vector<uint8_t> padded(length, Op::identity);
+    std::vector<uint8_t> prefix(length);
+    std::vector<uint8_t> suffix(length);
 
     for (int i = 0; i < rows; ++i) {
-        for (int j = 0; j < cols; ++j) {
-            uint8_t minValue = 255;
+        std::copy(src.row(i), src.row(i) + cols, padded.begin() + half);
+
+        // Prefix within each block (left to right), suffix within each block (right to left)
+        for (int blockStart = 0; blockStart < length; blockStart += window) {
+            int blockEnd = blockStart + window - 1;
+
+            prefix[blockStart] = padded[blockStart];
+            for (int p = blockStart + 1; p <= blockEnd; ++p) {
+                prefix[p] = Op::apply(prefix[p - 1], padded[p]);
+            }
+
+            suffix[blockEnd] = padded[blockEnd];
+            for (int p = blockEnd - 1; p >= blockStart; --p) {
+                suffix[p] = Op::apply(suffix[p + 1], padded[p]);
+            }
+        }
 
-            for (int ki = -halfKernelRows; ki <= halfKernelRows; ++ki) {
-                for (int kj = -halfKernelColumns; kj <= halfKernelColumns; ++kj) {
-                    int x = i + ki;
-                    int y = j + kj;
+        // Window [x, x + window - 1] in padded coordinates is centered on original column x
+        uint8_t* out = dst + static_cast<size_t>(i) * cols;
+        for (int x = 0; x < cols; ++x) {
+            out[x] = Op::apply(suffix[x], prefix[x + window - 1]);
+        }
+    }
+}
 
-                    if (x >= 0 && x < rows && y >= 0 && y < cols) {
-                        minValue = std::min(minValue, buffer[x * cols + y]);
-                    }
-                }
+// 1-D min/max of height 2 * half + 1 along every column. The recurrences run over whole rows,
+// so the inner loops walk contiguous memory.
+template <typename Op>
+void vanHerkGilWermanColumns(const uint8_t* src, const MutableImageView& dst, int half) {
+    const int rows = dst.height;
+    const int cols = dst.width;
+    const int window = 2 * half + 1;
+    const int length = paddedLength(rows, half);
+
+    std::vector<uint8_t> identityRow(cols, Op::identity);
+    std::vector<uint8_t> prefix(static_cast<size_t>(length) * cols);
+    std::vector<uint8_t> suffix(static_cast<size_t>(length) * cols);
+
+    auto paddedRow = [&](int p) -> const uint8_t* {
+        int r = p - half;
+        return (r >= 0 && r < rows) ? src + static_cast<size_t>(r) * cols : identityRow.data();
+    };
+    auto prefixRow = [&](int p) { return prefix.data() + static_cast<size_t>(p) * cols; };
+    auto suffixRow = [&](int p) { return suffix.data() + static_cast<size_t>(p) * cols; };
+
+    for (int blockStart = 0; blockStart < length; blockStart += window) {
+        int blockEnd = blockStart + window - 1;
+
+        std::copy(paddedRow(blockStart), paddedRow(blockStart) + cols, prefixRow(blockStart));
+        for (int p = blockStart + 1; p <= blockEnd; ++p) {
+            const uint8_t* in = paddedRow(p);
+            const uint8_t* previous = prefixRow(p - 1);
+            uint8_t* current = prefixRow(p);
+            for (int j = 0; j < cols; ++j) {
+                current[j] = Op::apply(previous[j], in[j]);
             }
+        }
 
-            outputBuffer[i * cols + j] = minValue;
+        std::copy(paddedRow(blockEnd), paddedRow(blockEnd) + cols, suffixRow(blockEnd));
+        for (int p = blockEnd - 1; p >= blockStart; --p) {
+            const uint8_t* in = paddedRow(p);
+            const uint8_t* next = suffixRow(p + 1);
+            uint8_t* current = suffixRow(p);
+            for (int j = 0; j < cols; ++j) {
+                current[j] = Op::apply(next[j], in[j]);
+            }
         }
     }
 
-    return outputBuffer;
+    for (int x = 0; x < rows; ++x) {
+        const uint8_t* top = suffixRow(x);
+        const uint8_t* bottom = prefixRow(x + window - 1);
+        uint8_t* out = dst.row(x);
+        for (int j = 0; j < cols; ++j) {
+            out[j] = Op::apply(top[j], bottom[j]);
+        }
+    }
 }
 
-// Dilation
-std::vector<uint8_t> applyDilation(const ImageReadResult& inputImage, int kernelColumns, int kernelRows) {
-    const uint8_t* buffer = inputImage.buffer->data();
-    const ImageMetadata& meta = inputImage.meta;
+// Rectangular min/max filter: row pass, then column pass
+template <typename Op>
+void rectangularMorphology(const ImageView& input, const MutableImageView& output, int kernelColumns, int kernelRows) {
+    if (!input.isValid() || input.channels != 1) {
+        throw std::invalid_argument("Morphology needs a valid single-channel view!");
+    }
+    requireSameSize(input, output);
 
-    int rows = meta.height;
-    int cols = meta.width;
     int halfKernelColumns = kernelColumns / 2;
     int halfKernelRows = kernelRows / 2;
 
-    std::vector<uint8_t> outputBuffer(rows * cols, 255);
-
-    for (int i = 0; i < rows; ++i) {
-        for (int j = 0; j < cols; ++j) {
-            uint8_t maxValue = 0;
+    parallelRowBands(input, output, halfKernelRows, [=](const ImageView& band, const MutableImageView& bandOutput) {
+        std::vector<uint8_t> rowPass(static_cast<size_t>(band.height) * band.width);
 
-            for (int ki = -halfKernelRows; ki <= halfKernelRows; ++ki) {
-                for (int kj = -halfKernelColumns; kj <= halfKernelColumns; ++kj) {
-                    int x = i + ki;
-                    int y = j + kj;
+        vanHerkGilWermanRows<Op>(band, rowPass.data(), halfKernelColumns);
+        vanHerkGilWermanColumns<Op>(rowPass.data(), bandOutput, halfKernelRows);
+    });
+}
 
-                    if (x >= 0 && x < rows && y >= 0 && y < cols) {
-                        maxValue = std::max(maxValue, buffer[x * cols + y]);
-                    }
-                }
-            }
+template <typename Op>
+std::vector<uint8_t> rectangularMorphology(const ImageView& input, int kernelColumns, int kernelRows) {
+    std::vector<uint8_t> outputBuffer(static_cast<size_t>(input.width) * input.height);
+    rectangularMorphology<Op>(input, makeImageView(outputBuffer.data(), input.width, input.height), kernelColumns, kernelRows);
+    return outputBuffer;
+}
 
-            outputBuffer[i * cols + j] = maxValue;
-        }
+// First then Second, through one intermediate buffer; the input is never copied
+template <typename First, typename Second>
+void sequentialMorphology(const ImageView& input, const MutableImageView& output, int kernelColumns, int kernelRows) {
+    if (!input.isValid() || input.channels != 1) {
+        throw std::invalid_argument("Morphology needs a valid single-channel view!");
     }
 
+    std::vector<uint8_t> intermediate(static_cast<size_t>(input.width) * input.height);
+    ImageView intermediateView = makeImageView(intermediate.data(), input.width, input.height);
+    rectangularMorphology<First>(input, makeImageView(intermediate.data(), input.width, input.height), kernelColumns, kernelRows);
+    rectangularMorphology<Second>(intermediateView, output, kernelColumns, kernelRows);
+}
+
+template <typename First, typename Second>
+std::vector<uint8_t> sequentialMorphology(const ImageView& input, int kernelColumns, int kernelRows) {
+    std::vector<uint8_t> outputBuffer(static_cast<size_t>(input.width) * input.height);
+    sequentialMorphology<First, Second>(input, makeImageView(outputBuffer.data(), input.width, input.height), kernelColumns, kernelRows);
     return outputBuffer;
 }
 
+} // namespace
+
+// Erosion
+std::vector<uint8_t> applyErosion(const ImageReadResult& inputImage, int kernelColumns, int kernelRows) {
+    if (!inputImage.meta.isValid() || !inputImage.buffer.has_value()) {
+        throw std::invalid_argument("Invalid image metadata or missing buffer!");
+    }
+    return rectangularMorphology<MinOp>(makeGrayscaleView(inputImage), kernelColumns, kernelRows);
+}
+
+std::vector<uint8_t> applyErosion(const ImageView& input, int kernelColumns, int kernelRows) {
+    return rectangularMorphology<MinOp>(input, kernelColumns, kernelRows);
+}
+
+void applyErosion(const ImageView& input, const MutableImageView& output, int kernelColumns, int kernelRows) {
+    rectangularMorphology<MinOp>(input, output, kernelColumns, kernelRows);
+}
+
+// Dilation
+std::vector<uint8_t> applyDilation(const ImageReadResult& inputImage, int kernelColumns, int kernelRows) {
+    if (!inputImage.meta.isValid() || !inputImage.buffer.has_value()) {
+        throw std::invalid_argument("Invalid image metadata or missing buffer!");
+    }
+    return rectangularMorphology<MaxOp>(makeGrayscaleView(inputImage), kernelColumns, kernelRows);
+}
+
+std::vector<uint8_t> applyDilation(const ImageView& input, int kernelColumns, int kernelRows) {
+    return rectangularMorphology<MaxOp>(input, kernelColumns, kernelRows);
+}
+
+void applyDilation(const ImageView& input, const MutableImageView& output, int kernelColumns, int kernelRows) {
+    rectangularMorphology<MaxOp>(input, output, kernelColumns, kernelRows);
+}
+
 // Opening: Erosion followed by Dilation
 std::vector<uint8_t> applyOpening(const ImageReadResult& inputImage, int kernelColumns, int kernelRows) {
-    ImageReadResult tempImage = inputImage;
-    tempImage.buffer = applyErosion(inputImage, kernelColumns, kernelRows);
+    if (!inputImage.meta.isValid() || !inputImage.buffer.has_value()) {
+        throw std::invalid_argument("Invalid image metadata or missing buffer!");
+    }
+    return sequentialMorphology<MinOp, MaxOp>(makeGrayscaleView(inputImage), kernelColumns, kernelRows);
+}
 
-    return applyDilation(tempImage, kernelColumns, kernelRows);
+std::vector<uint8_t> applyOpening(const ImageView& input, int kernelColumns, int kernelRows) {
+    return sequentialMorphology<MinOp, MaxOp>(input, kernelColumns, kernelRows);
+}
+
+void applyOpening(const ImageView& input, const MutableImageView& output, int kernelColumns, int kernelRows) {
+    sequentialMorphology<MinOp, MaxOp>(input, output, kernelColumns, kernelRows);
 }
 
 // Closing: Dilation followed by Erosion
 std::vector<uint8_t> applyClosing(const ImageReadResult& inputImage, int kernelColumns, int kernelRows) {
-    ImageReadResult tempImage = inputImage;
-    tempImage.buffer = applyDilation(inputImage, kernelColumns, kernelRows);
+    if (!inputImage.meta.isValid() || !inputImage.buffer.has_value()) {
+        throw std::invalid_argument("Invalid image metadata or missing buffer!");
+    }
+    return sequentialMorphology<MaxOp, MinOp>(makeGrayscaleView(inputImage), kernelColumns, kernelRows);
+}
 
-    return applyErosion(tempImage, kernelColumns, kernelRows);
+std::vector<uint8_t> applyClosing(const ImageView& input, int kernelColumns, int kernelRows) {
+    return sequentialMorphology<MaxOp, MinOp>(input, kernelColumns, kernelRows);
+}
+
+void applyClosing(const ImageView& input, const MutableImageView& output, int kernelColumns, int kernelRows) {
+    sequentialMorphology<MaxOp, MinOp>(input, output, kernelColumns, kernelRows);
 }
 
 // Boundary extraction: Erosion followed by set difference
@@ -117,96 +272,152 @@ std::vector<uint8_t> applyBoundaryExtraction(const ImageReadResult& inputImage,
 
 // Hole Filling Implementation
 
-// incomplete testing
+/* Hole filling computes X_k = (X_(k-1) dilated by B) intersected with the complement of A until it stops
+ * changing. That fixed point is the set of background pixels reachable from the seed through steps that
+ * are offsets of the structuring element B and that only land on background pixels, so it is computed
+ * with a FIFO flood fill instead of repeated full-image dilations. Background pixels are marked when they
+ * are enqueued (seeds included), so every pixel other than a foreground seed enters the queue at most
+ * once and the cost is O(pixels * |B|) independent of the hole size.
+ */
+
+namespace {
+
+using SeedList = std::vector<std::pair<int, int>>;
+
+// Marks (255) every background pixel reachable from the seeds. Seeds act as sources even when they are
+// foreground, exactly like X_0 in the iterative formulation.
+std::vector<uint8_t> floodFillBackground(const uint8_t* buffer, int rows, int cols, const SeedList& seedPoints,
+                                         int kernelColumns, int kernelRows, size_t& filledCount) {
+    // Neighbour offsets of the structuring element (a 3x3 element gives 8-connectivity)
+    std::vector<std::pair<int, int>> offsets;
+    for (int ki = -kernelRows / 2; ki <= kernelRows / 2; ++ki) {
+        for (int kj = -kernelColumns / 2; kj <= kernelColumns / 2; ++kj) {
+            offsets.emplace_back(ki, kj);
+        }
+    }
+
+    std::vector<uint8_t> reached(static_cast<size_t>(rows) * cols, 0);
+    std::vector<int> queue;
+    queue.reserve(seedPoints.size());
+    filledCount = 0;
+
+    for (const auto& seed : seedPoints) {
+        int index = seed.first * cols + seed.second;
+        if (buffer[index] == 0) {
+            if (reached[index] != 0) {
+                continue;   // duplicate seed
+            }
+            reached[index] = 255;
+            filledCount++;
+        }
+        queue.push_back(index);
+    }
+
+    // The vector is used as a FIFO: head walks forward, new pixels are appended
+    for (size_t head = 0; head < queue.size(); ++head) {
+        int i = queue[head] / cols;
+        int j = queue[head] % cols;
+
+        for (const auto& offset : offsets) {
+            int x = i + offset.first;
+            int y = j + offset.second;
+            if (x < 0 || x >= rows || y < 0 || y >= cols) {
+                continue;
+            }
+
+            int index = x * cols + y;
+            if (buffer[index] == 0 && reached[index] == 0) {
+                reached[index] = 255;
+                queue.push_back(index);
+                filledCount++;
+            }
+        }
+    }
+
+    return reached;
+}
+
+void validateSeeds(const ImageMetadata& meta, const SeedList& seedPoints) {
+    for (const auto& seed : seedPoints) {
+        if (seed.first < 0 || seed.first >= meta.height || seed.second < 0 || seed.second >= meta.width) {
+            throw std::invalid_argument("Seed point (" + std::to_string(seed.first) + ", " +
+                                        std::to_string(seed.second) + ") is outside the image!");
+        }
+    }
+}
+
+} // namespace
+
 std::vector<uint8_t> applyHoleFilling(const ImageReadResult& inputImage, const std::pair<int, int>& seedPoint, int kernelColumns, int kernelRows) {
+    return applyMultiSeedHoleFilling(inputImage, {seedPoint}, kernelColumns, kernelRows);
+}
+
+std::vector<uint8_t> applyMultiSeedHoleFilling(const ImageReadResult& inputImage, const std::vector<std::pair<int, int>>& seedPoints, int kernelColumns, int kernelRows) {
+    if (!inputImage.meta.isValid() || !inputImage.buffer.has_value()) {
+        throw std::invalid_argument("Invalid image metadata or missing buffer!");
+    }
+    validateSeeds(inputImage.meta, seedPoints);
+
     const uint8_t* buffer = inputImage.buffer->data();
     const ImageMetadata& meta = inputImage.meta;
 
     int rows = meta.height;
     int cols = meta.width;
 
-    // Step 1: Initialize seed image, X_0
-    std::vector<uint8_t> seedImage(rows * cols, 0);
-    seedImage[seedPoint.first * cols + seedPoint.second] = 255;
+    // Step 1: Grow the seeds through the background (complement of the input)
+    size_t filledCount = 0;
+    std::vector<uint8_t> holes = floodFillBackground(buffer, rows, cols, seedPoints, kernelColumns, kernelRows, filledCount);
 
-    // Step 2: Compute complement of the input image
-    std::vector<uint8_t> complementImage(rows * cols, 0);
+    // Step 2: Add filled region to the original image
+    std::vector<uint8_t> filledImage(rows * cols, 0);
     for (int i = 0; i < rows * cols; ++i) {
-        complementImage[i] = (buffer[i] == 0) ? 255 : 0;
+        filledImage[i] = (buffer[i] == 255 || holes[i] == 255) ? 255 : 0;
     }
 
-    // Step 3: Iterative dilation and intersection
-    std::vector<uint8_t> currentImage = seedImage;      // X_k
-    std::vector<uint8_t> nextImage(rows * cols, 0);     // X_(k+1)
-    bool hasChanged;
+    std::cout << "Hole filling: " << filledCount << " pixels filled from " << seedPoints.size() << " seed(s)" << std::endl;
 
-    int dilationCount = 0;
+    return filledImage;
+}
 
-    do {
-        hasChanged = false;
+std::vector<uint8_t> applyAutomaticHoleFilling(const ImageReadResult& inputImage, int kernelColumns, int kernelRows) {
+    if (!inputImage.meta.isValid() || !inputImage.buffer.has_value()) {
+        throw std::invalid_argument("Invalid image metadata or missing buffer!");
+    }
 
-        // Perform dilation
-        for (int i = 0; i < rows; ++i) {
-            for (int j = 0; j < cols; ++j) {
-                if (currentImage[i * cols + j] == 255) {
-                    for (int ki = -kernelRows / 2; ki <= kernelRows / 2; ++ki) {
-                        for (int kj = -kernelColumns / 2; kj <= kernelColumns / 2; ++kj) {
-                            int x = i + ki;
-                            int y = j + kj;
-                            if (x >= 0 && x < rows && y >= 0 && y < cols) {
-                                if (complementImage[x * cols + y] == 255 && nextImage[x * cols + y] == 0) {
-                                    nextImage[x * cols + y] = 255;
-                                    hasChanged = true;
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
+    const uint8_t* buffer = inputImage.buffer->data();
+    const ImageMetadata& meta = inputImage.meta;
 
-        std::cout << "Dilation Step " << dilationCount + 1 << ": Filled Pixels = " 
-                  << std::count(nextImage.begin(), nextImage.end(), 255) << std::endl;
+    int rows = meta.height;
+    int cols = meta.width;
 
-        currentImage = nextImage;
-        dilationCount++;
+    // Step 1: Seed from every background pixel on the image border
+    SeedList borderSeeds;
+    auto addIfBackground = [&](int i, int j) {
+        if (buffer[i * cols + j] == 0) borderSeeds.emplace_back(i, j);
+    };
+    for (int j = 0; j < cols; ++j) {
+        addIfBackground(0, j);
+        if (rows > 1) addIfBackground(rows - 1, j);
+    }
+    for (int i = 1; i < rows - 1; ++i) {
+        addIfBackground(i, 0);
+        if (cols > 1) addIfBackground(i, cols - 1);
+    }
 
-    } while (hasChanged);
+    // Step 2: Everything reachable from the border is outside background
+    size_t outsideCount = 0;
+    std::vector<uint8_t> outside = floodFillBackground(buffer, rows, cols, borderSeeds, kernelColumns, kernelRows, outsideCount);
 
-    // Step 4: Add filled region to the original image
+    // Step 3: Background pixels that were not reached are holes
     std::vector<uint8_t> filledImage(rows * cols, 0);
+    size_t filledCount = 0;
     for (int i = 0; i < rows * cols; ++i) {
-        // Copy the original image
-        if (buffer[i] == 255) {
-            filledImage[i] = 255; // Preserve original foreground
-        } else if (currentImage[i] == 255) {
-            filledImage[i] = 255; // Add the filled hole
-        } else {
-            filledImage[i] = 0; // Preserve original background
-        }
+        bool isHole = (buffer[i] == 0 && outside[i] == 0);
+        filledImage[i] = (buffer[i] == 255 || isHole) ? 255 : 0;
+        filledCount += isHole;
     }
 
-    // Debugging: Verify final image values
-    int foregroundPixels = std::count(filledImage.begin(), filledImage.end(), 255);
-    int backgroundPixels = std::count(filledImage.begin(), filledImage.end(), 0);
-    std::cout << "Filled Image: Background Pixels = " << backgroundPixels 
-              << ", Foreground Pixels = " << foregroundPixels << std::endl;
-
-              // Debugging: Verify final image values
-    int foregroundPixelsb = std::count(filledImage.begin(), filledImage.end(), 255);
-    int backgroundPixelsb = std::count(filledImage.begin(), filledImage.end(), 0);
-    std::cout << "buffer Image: Background Pixels = " << backgroundPixelsb 
-              << ", Foreground Pixels = " << foregroundPixelsb << std::endl;
-
-    // Debugging: Verify final image values
-    int foregroundPixelsc = std::count(currentImage.begin(), currentImage.end(), 255);
-    int backgroundPixelsc = std::count(currentImage.begin(), currentImage.end(), 0);
-    std::cout << "current image: Background Pixels = " << backgroundPixelsc 
-              << ", Foreground Pixels = " << foregroundPixelsc << std::endl;
+    std::cout << "Automatic hole filling: " << filledCount << " pixels filled" << std::endl;
 
     return filledImage;
-
-    //return currentImage;
 }
-
-
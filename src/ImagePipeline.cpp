@@ -0,0 +1,420 @@
+#include "ImagePipeline.h"
+#include "IntensityTransformations.h"
+#include "ImageHistogram.h"
+#include "ImageFilter.h"
+#include "ImageConverter.h"
+#include "ImageMorphology.h"
+#include "ImageEdgeDetection.h"
+#include "LookupTable.h"
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+enum class ParameterKind { INTEGER, REAL, CHOICE, PATH };
+
+struct ParameterInfo {
+    const char* key;
+    ParameterKind kind;
+    const char* defaultValue;   // empty: optional, no default (PATH parameters are required)
+    const char* choices;        // '|'-separated, CHOICE only
+};
+
+// Table of a point operation, given the histogram of the image as the step sees it (empty unless the
+// operation needs it)
+using PointTableFunction = std::function<LookupTable(const PipelineStep&, const std::vector<uint64_t>& histogram)>;
+
+using ApplyFunction = std::function<void(ImageReadResult&, const PipelineStep&)>;
+
+// Built through the constructor, so table entries may leave out the point-operation fields
+struct OperationInfo {
+    const char* name;
+    std::vector<ParameterInfo> parameters;
+    ApplyFunction apply;                // empty for point operations
+    PointTableFunction pointTable;      // point operations only
+    bool needsHistogram;
+
+    OperationInfo(const char* name, std::vector<ParameterInfo> parameters, ApplyFunction apply,
+                  PointTableFunction pointTable = nullptr, bool needsHistogram = false)
+        : name(name), parameters(std::move(parameters)), apply(std::move(apply)),
+          pointTable(std::move(pointTable)), needsHistogram(needsHistogram) {}
+};
+
+KernelChoice kernelFromName(const std::string& name) {
+    if (name == "sobel") return KernelChoice::SOBEL;
+    if (name == "prewitt") return KernelChoice::PREWITT;
+    return KernelChoice::ROBERTS;
+}
+
+AdaptiveThresholdMethod adaptiveMethodFromName(const std::string& name) {
+    if (name == "gaussian") return AdaptiveThresholdMethod::GAUSSIAN;
+    if (name == "niblack") return AdaptiveThresholdMethod::NIBLACK;
+    if (name == "sauvola") return AdaptiveThresholdMethod::SAUVOLA;
+    return AdaptiveThresholdMethod::MEAN;
+}
+
+GaussianEngine gaussianEngineFromName(const std::string& name) {
+    return (name == "recursive") ? GaussianEngine::RECURSIVE : GaussianEngine::SEPARABLE;
+}
+
+CannyEngine cannyEngineFromName(const std::string& name) {
+    if (name == "fused") return CannyEngine::FUSED;
+    if (name == "tiled") return CannyEngine::TILED;
+    return CannyEngine::STAGED;
+}
+
+LaplacianMethod laplacianMethodFromName(const std::string& name) {
+    return (name == "dog") ? LaplacianMethod::DOG : LaplacianMethod::LOG;
+}
+
+PaddingChoice paddingFromName(const std::string& name) {
+    if (name == "none") return PaddingChoice::NONE;
+    if (name == "zero") return PaddingChoice::ZERO;
+    if (name == "replicate") return PaddingChoice::REPLICATE;
+    return PaddingChoice::REFLECT;
+}
+
+// Reference distributions of "match" steps by path: loaded once, then shared by every image of a batch
+const std::vector<double>& referenceDistribution(const std::string& path) {
+    static std::mutex cacheMutex;
+    static std::map<std::string, std::vector<double>> cache;
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto it = cache.find(path);
+    if (it == cache.end()) {
+        it = cache.emplace(path, cumulativeDistribution(loadReferenceHistogram(path))).first;
+    }
+    return it->second;
+}
+
+const std::vector<ParameterInfo> morphologyParameters = {
+    {"kc", ParameterKind::INTEGER, "3", ""},
+    {"kr", ParameterKind::INTEGER, "3", ""},
+};
+
+const std::vector<OperationInfo>& operationTable() {
+    static const std::vector<OperationInfo> table = {
+        // Intensity transformations (point operations, fused with their neighbours)
+        {"negative", {}, nullptr, [](const PipelineStep&, const std::vector<uint64_t>&) {
+            return negativeTable();
+        }},
+        {"log", {{"c", ParameterKind::REAL, "-1", ""}}, nullptr, [](const PipelineStep& step, const std::vector<uint64_t>&) {
+            return logTable(step.doubleParameter("c"));
+        }},
+        {"gamma", {{"c", ParameterKind::REAL, "-1", ""}, {"g", ParameterKind::REAL, "-1", ""}}, nullptr,
+         [](const PipelineStep& step, const std::vector<uint64_t>&) {
+            return gammaTable(step.doubleParameter("c"), step.doubleParameter("g"));
+        }},
+        {"equalize", {}, nullptr, [](const PipelineStep&, const std::vector<uint64_t>& histogram) {
+            return equalizationTable(histogram);
+        }, true},
+        {"match", {{"ref", ParameterKind::PATH, "", ""}}, nullptr, [](const PipelineStep& step, const std::vector<uint64_t>& histogram) {
+            return specificationTable(histogram, referenceDistribution(step.stringParameter("ref")));
+        }, true},
+
+        // Adaptive equalization: the mapping depends on the position, so it is not a point operation
+        {"clahe", {{"tile", ParameterKind::INTEGER, "64", ""}, {"clip", ParameterKind::REAL, "2.0", ""}},
+         [](ImageReadResult& image, const PipelineStep& step) {
+            image.buffer = applyCLAHE(image, step.intParameter("tile"), step.doubleParameter("clip"));
+        }},
+
+        // Spatial filtering
+        {"box", {{"k", ParameterKind::INTEGER, "3", ""}}, [](ImageReadResult& image, const PipelineStep& step) {
+            image.buffer = applyBoxFilter(image, step.intParameter("k"));
+        }},
+        {"gaussian", {{"k", ParameterKind::INTEGER, "5", ""}, {"s", ParameterKind::REAL, "1.0", ""},
+                      {"engine", ParameterKind::CHOICE, "separable", "separable|recursive"}},
+         [](ImageReadResult& image, const PipelineStep& step) {
+            image.buffer = applyGaussianFilter(image, step.intParameter("k"), step.doubleParameter("s"),
+                                               gaussianEngineFromName(step.stringParameter("engine")));
+        }},
+        {"median", {{"k", ParameterKind::INTEGER, "3", ""}}, [](ImageReadResult& image, const PipelineStep& step) {
+            image.buffer = applyMedianFilter(image, step.intParameter("k"));
+        }},
+        {"highpass", {{"kernel", ParameterKind::INTEGER, "1", ""}}, [](ImageReadResult& image, const PipelineStep& step) {
+            image.buffer = applyHighPassFilter(image, step.intParameter("kernel"));
+        }},
+        {"sharpen", {{"kernel", ParameterKind::INTEGER, "1", ""}}, [](ImageReadResult& image, const PipelineStep& step) {
+            image.buffer = applyImageSharpening(image, step.intParameter("kernel"));
+        }},
+        {"umhbf", {{"k", ParameterKind::REAL, "1.0", ""},
+                   {"blur", ParameterKind::CHOICE, "gaussian", "box|gaussian|median|recursive"},
+                   {"size", ParameterKind::INTEGER, "5", ""}, {"s", ParameterKind::REAL, "1.0", ""}},
+         [](ImageReadResult& image, const PipelineStep& step) {
+            const std::string& blur = step.stringParameter("blur");
+            int kernelChoice = (blur == "box") ? 1 : (blur == "gaussian") ? 2 : (blur == "median") ? 3 : 4;
+            image.buffer = applyUMHBF(image, step.doubleParameter("k"), kernelChoice,
+                                      step.intParameter("size"), step.doubleParameter("s"));
+        }},
+
+        // Conversion
+        {"binary", {{"t", ParameterKind::INTEGER, "128", ""}}, nullptr, [](const PipelineStep& step, const std::vector<uint64_t>&) {
+            return thresholdTable(step.intParameter("t"));
+        }},
+        {"otsu", {}, nullptr, [](const PipelineStep&, const std::vector<uint64_t>& histogram) {
+            return thresholdTable(otsuThreshold(histogram));
+        }, true},
+        {"adaptive", {{"method", ParameterKind::CHOICE, "mean", "mean|gaussian|niblack|sauvola"},
+                      {"w", ParameterKind::INTEGER, "15", ""},
+                      {"k", ParameterKind::REAL, "", ""},
+                      {"c", ParameterKind::REAL, "0", ""}},
+         [](ImageReadResult& image, const PipelineStep& step) {
+            AdaptiveThresholdMethod method = adaptiveMethodFromName(step.stringParameter("method"));
+            double k = step.hasParameter("k") ? step.doubleParameter("k")
+                     : (method == AdaptiveThresholdMethod::SAUVOLA) ? DEFAULT_SAUVOLA_K : DEFAULT_NIBLACK_K;
+            image.buffer = applyAdaptiveThreshold(image, method, step.intParameter("w"), k, step.doubleParameter("c"));
+        }},
+
+        // Morphology
+        {"erode", morphologyParameters, [](ImageReadResult& image, const PipelineStep& step) {
+            image.buffer = applyErosion(image, step.intParameter("kc"), step.intParameter("kr"));
+        }},
+        {"dilate", morphologyParameters, [](ImageReadResult& image, const PipelineStep& step) {
+            image.buffer = applyDilation(image, step.intParameter("kc"), step.intParameter("kr"));
+        }},
+        {"open", morphologyParameters, [](ImageReadResult& image, const PipelineStep& step) {
+            image.buffer = applyOpening(image, step.intParameter("kc"), step.intParameter("kr"));
+        }},
+        {"close", morphologyParameters, [](ImageReadResult& image, const PipelineStep& step) {
+            image.buffer = applyClosing(image, step.intParameter("kc"), step.intParameter("kr"));
+        }},
+        {"boundary", morphologyParameters, [](ImageReadResult& image, const PipelineStep& step) {
+            image.buffer = applyBoundaryExtraction(image, step.intParameter("kc"), step.intParameter("kr"));
+        }},
+        {"fillholes", morphologyParameters, [](ImageReadResult& image, const PipelineStep& step) {
+            image.buffer = applyAutomaticHoleFilling(image, step.intParameter("kc"), step.intParameter("kr"));
+        }},
+
+        // Edge detection; gradient without t produces a normalized magnitude map
+        {"gradient", {{"kernel", ParameterKind::CHOICE, "sobel", "sobel|prewitt|roberts"},
+                      {"t", ParameterKind::REAL, "", ""},
+                      {"pad", ParameterKind::CHOICE, "replicate", "none|zero|replicate|reflect"},
+                      {"norm", ParameterKind::CHOICE, "l2", "l2|l1"}},
+         [](ImageReadResult& image, const PipelineStep& step) {
+            bool applyThreshold = step.hasParameter("t");
+            GradientNorm norm = (step.stringParameter("norm") == "l1") ? GradientNorm::L1 : GradientNorm::L2;
+            image.buffer = applyGradientEdgeDetection(image, kernelFromName(step.stringParameter("kernel")), applyThreshold,
+                                                      applyThreshold ? step.doubleParameter("t") : 0.0,
+                                                      paddingFromName(step.stringParameter("pad")), norm);
+        }},
+        {"canny", {{"lo", ParameterKind::REAL, "20", ""}, {"hi", ParameterKind::REAL, "60", ""},
+                   {"s", ParameterKind::REAL, "1.4", ""}, {"k", ParameterKind::INTEGER, "5", ""},
+                   {"pad", ParameterKind::CHOICE, "replicate", "none|zero|replicate|reflect"},
+                   {"engine", ParameterKind::CHOICE, "staged", "staged|fused|tiled"},
+                   {"smoothing", ParameterKind::CHOICE, "separable", "separable|recursive"}},
+         [](ImageReadResult& image, const PipelineStep& step) {
+            image.buffer = applyCannyEdgeDetection(image, step.doubleParameter("lo"), step.doubleParameter("hi"),
+                                                   step.doubleParameter("s"), step.intParameter("k"),
+                                                   paddingFromName(step.stringParameter("pad")),
+                                                   cannyEngineFromName(step.stringParameter("engine")),
+                                                   gaussianEngineFromName(step.stringParameter("smoothing")));
+        }},
+        {"laplacian", {{"s", ParameterKind::REAL, "2.0", ""}, {"t", ParameterKind::REAL, "0", ""},
+                       {"method", ParameterKind::CHOICE, "log", "log|dog"},
+                       {"pad", ParameterKind::CHOICE, "replicate", "none|zero|replicate|reflect"}},
+         [](ImageReadResult& image, const PipelineStep& step) {
+            image.buffer = applyLaplacianEdgeDetection(image, step.doubleParameter("s"), step.doubleParameter("t"),
+                                                       laplacianMethodFromName(step.stringParameter("method")),
+                                                       paddingFromName(step.stringParameter("pad")));
+        }},
+    };
+    return table;
+}
+
+const OperationInfo* findOperation(const std::string& name) {
+    for (const OperationInfo& operation : operationTable()) {
+        if (name == operation.name) {
+            return &operation;
+        }
+    }
+    return nullptr;
+}
+
+/* Composes the run of point operations that starts at first into one table and applies it in a single
+ * pass. A step that needs the histogram gets the histogram of the input pushed through the table
+ * composed so far, which is exactly the histogram of the image it would have seen, so the input is read
+ * once more at most. Returns the first step that is not part of the run.
+ */
+const PipelineStep* applyPointOperations(ImageReadResult& image, const PipelineStep* first, const PipelineStep* last) {
+    LookupTable table = LookupTable::identity();
+    std::vector<uint64_t> inputHistogram;
+
+    const PipelineStep* step = first;
+    for (; step != last; ++step) {
+        const OperationInfo* operation = findOperation(step->operation);
+        if (operation == nullptr || !operation->pointTable) {
+            break;
+        }
+
+        std::vector<uint64_t> histogram;
+        if (operation->needsHistogram) {
+            if (inputHistogram.empty()) {
+                inputHistogram = computeHistogram(makeGrayscaleView(image));
+            }
+            histogram = remapHistogram(inputHistogram, table);
+        }
+        table = table.then(operation->pointTable(*step, histogram));
+    }
+
+    std::vector<uint8_t>& buffer = *image.buffer;
+    applyLookupTable(table, buffer.data(), buffer.data(), buffer.size());
+    return step;
+}
+
+void validatePipelineImage(const ImageReadResult& image) {
+    if (!image.meta.isValid() || !image.buffer.has_value()) {
+        throw std::invalid_argument("Invalid image metadata or missing buffer!");
+    }
+    if (image.meta.bitDepth != 8) {
+        throw std::invalid_argument("Pipeline steps need an 8-bit grayscale image!");
+    }
+}
+
+bool isValidValue(const ParameterInfo& parameter, const std::string& value) {
+    if (value.empty()) {
+        return false;
+    }
+
+    size_t consumed = 0;
+    try {
+        switch (parameter.kind) {
+            case ParameterKind::INTEGER:
+                std::stoi(value, &consumed);
+                return consumed == value.size();
+            case ParameterKind::REAL:
+                std::stod(value, &consumed);
+                return consumed == value.size();
+            case ParameterKind::CHOICE:
+                return ("|" + std::string(parameter.choices) + "|").find("|" + value + "|") != std::string::npos;
+            case ParameterKind::PATH:
+                return std::ifstream(value).good();   // a typo fails here, before any image is touched
+        }
+    } catch (const std::exception&) {
+        return false;
+    }
+    return false;
+}
+
+} // namespace
+
+bool PipelineStep::hasParameter(const std::string& key) const {
+    return parameters.count(key) != 0;
+}
+
+const std::string& PipelineStep::stringParameter(const std::string& key) const {
+    auto it = parameters.find(key);
+    if (it == parameters.end()) {
+        throw std::invalid_argument("Missing parameter '" + key + "' for " + operation);
+    }
+    return it->second;
+}
+
+int PipelineStep::intParameter(const std::string& key) const {
+    return std::stoi(stringParameter(key));
+}
+
+double PipelineStep::doubleParameter(const std::string& key) const {
+    return std::stod(stringParameter(key));
+}
+
+PipelineStep parsePipelineStep(const std::string& specification) {
+    PipelineStep step;
+
+    size_t colon = specification.find(':');
+    step.operation = specification.substr(0, colon);
+
+    const OperationInfo* operation = findOperation(step.operation);
+    if (operation == nullptr) {
+        throw std::invalid_argument("Unknown operation '" + step.operation + "'");
+    }
+
+    // key=value pairs
+    if (colon != std::string::npos) {
+        std::stringstream list(specification.substr(colon + 1));
+        std::string pair;
+        while (std::getline(list, pair, ',')) {
+            size_t equals = pair.find('=');
+            std::string key = pair.substr(0, equals);
+            std::string value = (equals == std::string::npos) ? "" : pair.substr(equals + 1);
+
+            auto parameter = std::find_if(operation->parameters.begin(), operation->parameters.end(),
+                                          [&key](const ParameterInfo& info) { return key == info.key; });
+            if (parameter == operation->parameters.end()) {
+                throw std::invalid_argument("Unknown parameter '" + key + "' for " + step.operation);
+            }
+            if (!isValidValue(*parameter, value)) {
+                throw std::invalid_argument("Invalid value '" + value + "' for " + step.operation + ":" + key);
+            }
+            step.parameters[key] = value;
+        }
+    }
+
+    // Defaults for everything that was left out
+    for (const ParameterInfo& parameter : operation->parameters) {
+        if (step.hasParameter(parameter.key)) {
+            continue;
+        }
+        if (parameter.kind == ParameterKind::PATH) {
+            throw std::invalid_argument("Missing parameter '" + std::string(parameter.key) + "' for " + step.operation);
+        }
+        if (parameter.defaultValue[0] != '\0') {
+            step.parameters[parameter.key] = parameter.defaultValue;
+        }
+    }
+
+    return step;
+}
+
+void applyPipelineStep(ImageReadResult& image, const PipelineStep& step) {
+    applyPipeline(image, {step});
+}
+
+void applyPipeline(ImageReadResult& image, const std::vector<PipelineStep>& steps) {
+    const PipelineStep* step = steps.data();
+    const PipelineStep* last = steps.data() + steps.size();
+
+    while (step != last) {
+        validatePipelineImage(image);
+
+        const OperationInfo* operation = findOperation(step->operation);
+        if (operation == nullptr) {
+            throw std::invalid_argument("Unknown operation '" + step->operation + "'");
+        }
+
+        if (operation->pointTable) {
+            step = applyPointOperations(image, step, last);
+        } else {
+            operation->apply(image, *step);
+            ++step;
+        }
+    }
+}
+
+std::string describePipelineOperations() {
+    std::ostringstream description;
+    for (const OperationInfo& operation : operationTable()) {
+        description << "  " << operation.name;
+        const char* separator = ":";
+        for (const ParameterInfo& parameter : operation.parameters) {
+            description << separator << parameter.key << "=";
+            if (parameter.kind == ParameterKind::CHOICE) {
+                description << parameter.defaultValue << " [" << parameter.choices << "]";
+            } else if (parameter.kind == ParameterKind::PATH) {
+                description << "<path>";
+            } else if (parameter.defaultValue[0] == '\0') {
+                description << "<optional>";
+            } else {
+                description << parameter.defaultValue;
+            }
+            separator = ",";
+        }
+        description << "\n";
+    }
+    return description.str();
+}
@@ -0,0 +1,498 @@
+#include "ImageStream.h"
+#include "ImageFilter.h"
+#include "ImageMorphology.h"
+#include "ImageEdgeDetection.h"
+#include "ImageHistogram.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+
+namespace {
+
+int32_t readInt32(const uint8_t* bytes) {
+    int32_t value;
+    std::memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+int16_t readInt16(const uint8_t* bytes) {
+    int16_t value;
+    std::memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+void writeInt32(uint8_t* bytes, uint32_t value) {
+    std::memcpy(bytes, &value, sizeof(value));
+}
+
+void writeInt16(uint8_t* bytes, uint16_t value) {
+    std::memcpy(bytes, &value, sizeof(value));
+}
+
+size_t paddedRowSize(const ImageMetadata& meta) {
+    return ((static_cast<size_t>(meta.width) * meta.bitDepth + 31) / 32) * 4;
+}
+
+/**
+ * Walks the image band by band. For each band the callback gets a view of the rows
+ * [windowBegin, windowEnd) = [coreBegin - halo, coreEnd + halo) clipped to the image, plus the core range.
+ * Rows shared by consecutive bands are kept in the window instead of being read again.
+ */
+template <typename Callback>
+bool forEachBand(BmpBandReader& reader, int haloRows, int bandRows, Callback&& callback) {
+    const int rows = reader.meta().height;
+    const int cols = reader.meta().width;
+
+    std::vector<uint8_t> window(static_cast<size_t>(cols) * std::min(rows, bandRows + 2 * haloRows));
+    int windowBegin = 0;
+    int windowEnd = 0;
+
+    for (int coreBegin = 0; coreBegin < rows; coreBegin += bandRows) {
+        int coreEnd = std::min(rows, coreBegin + bandRows);
+        int wantBegin = std::max(0, coreBegin - haloRows);
+        int wantEnd = std::min(rows, coreEnd + haloRows);
+
+        // Drop the rows that fell out of the window, keep the overlap
+        int keep = std::max(0, windowEnd - wantBegin);
+        if (keep > 0 && wantBegin > windowBegin) {
+            std::memmove(window.data(),
+                         window.data() + static_cast<size_t>(wantBegin - windowBegin) * cols,
+                         static_cast<size_t>(keep) * cols);
+        }
+        windowBegin = wantBegin;
+        windowEnd = wantBegin + keep;
+
+        if (!reader.readRows(window.data() + static_cast<size_t>(keep) * cols, wantEnd - windowEnd)) {
+            return false;
+        }
+        windowEnd = wantEnd;
+
+        ImageView band{window.data(), cols, windowEnd - windowBegin, cols};
+        callback(band, coreBegin - windowBegin, coreEnd - windowBegin);
+    }
+
+    return true;
+}
+
+} // namespace
+
+// Band reader ----
+
+bool BmpBandReader::open(const std::string& filePath) {
+    log(INFO, "Opening image for streaming: " + filePath);
+
+    file_.open(filePath, std::ios::binary);
+    if (!file_) {
+        log(ERROR, "Failed to open file: " + filePath);
+        return false;
+    }
+
+    uint8_t header[HEADER_SIZE];
+    if (!file_.read(reinterpret_cast<char*>(header), HEADER_SIZE)) {
+        log(ERROR, "File is too small to be a BMP file: " + filePath);
+        return false;
+    }
+
+    if (header[0] != 'B' || header[1] != 'M') {
+        log(ERROR, "File is not a valid BMP file.");
+        return false;
+    }
+
+    size_t pixelOffset = static_cast<uint32_t>(readInt32(header + 10));
+    meta_.width = readInt32(header + 18);
+    meta_.height = readInt32(header + 22);
+    meta_.bitDepth = readInt16(header + 28);
+
+    if (!meta_.isValid()) {
+        log(ERROR, "Invalid metadata extracted from image header.");
+        return false;
+    }
+
+    if (meta_.bitDepth != 8 && meta_.bitDepth != 24) {
+        log(ERROR, "Unsupported bit depth: " + std::to_string(meta_.bitDepth));
+        return false;
+    }
+
+    if (pixelOffset < HEADER_SIZE) {
+        log(ERROR, "Pixel data offset is out of range in: " + filePath);
+        return false;
+    }
+
+    // The color table sits between the header and the pixel data
+    if (meta_.bitDepth <= 8) {
+        colorTable_.resize(std::min(COLOR_TABLE_SIZE, pixelOffset - HEADER_SIZE));
+        if (!file_.read(reinterpret_cast<char*>(colorTable_.data()), colorTable_.size())) {
+            log(ERROR, "Failed to read color table.");
+            return false;
+        }
+    }
+
+    file_.seekg(static_cast<std::streamoff>(pixelOffset));
+    if (!file_) {
+        log(ERROR, "Failed to seek to pixel data.");
+        return false;
+    }
+
+    rowBuffer_.resize(paddedRowSize(meta_));
+    rowsRead_ = 0;
+
+    log(INFO, "Image Metadata: Width=" + std::to_string(meta_.width) +
+              ", Height=" + std::to_string(meta_.height) +
+              ", Bit Depth=" + std::to_string(meta_.bitDepth));
+    return true;
+}
+
+bool BmpBandReader::readRows(uint8_t* dst, int count) {
+    if (count < 0 || rowsRead_ + count > meta_.height) {
+        log(ERROR, "Attempt to read past the last image row.");
+        return false;
+    }
+
+    size_t rowBytes = static_cast<size_t>(meta_.width) * channels();
+    for (int r = 0; r < count; ++r) {
+        if (!file_.read(reinterpret_cast<char*>(rowBuffer_.data()), rowBuffer_.size())) {
+            log(ERROR, "Pixel data is truncated at row " + std::to_string(rowsRead_));
+            return false;
+        }
+        std::memcpy(dst + r * rowBytes, rowBuffer_.data(), rowBytes);
+        ++rowsRead_;
+    }
+    return true;
+}
+
+// Band writer ----
+
+bool BmpBandWriter::open(const std::string& filePath, const ImageMetadata& meta, const std::vector<uint8_t>& colorTable) {
+    log(INFO, "Writing image to: " + filePath);
+
+    if (!meta.isValid() || (meta.bitDepth != 8 && meta.bitDepth != 24)) {
+        log(ERROR, "Invalid metadata. Cannot write image.");
+        return false;
+    }
+
+    meta_ = meta;
+    rowsWritten_ = 0;
+
+    // 8-bit images without a palette get a grayscale ramp
+    std::vector<uint8_t> palette;
+    if (meta.bitDepth == 8) {
+        palette = colorTable;
+        if (palette.empty()) {
+            palette.resize(COLOR_TABLE_SIZE);
+            for (int i = 0; i < 256; ++i) {
+                palette[4 * i] = palette[4 * i + 1] = palette[4 * i + 2] = static_cast<uint8_t>(i);
+                palette[4 * i + 3] = 0;
+            }
+        }
+    }
+
+    // A fresh header: the one in the input may describe a different offset or file size
+    uint64_t pixelBytes = static_cast<uint64_t>(paddedRowSize(meta)) * meta.height;
+    uint64_t pixelOffset = HEADER_SIZE + palette.size();
+    uint64_t fileSize = pixelOffset + pixelBytes;
+    auto clampToField = [](uint64_t value) {
+        return value > std::numeric_limits<uint32_t>::max() ? 0u : static_cast<uint32_t>(value);
+    };
+
+    uint8_t header[HEADER_SIZE] = {0};
+    header[0] = 'B';
+    header[1] = 'M';
+    writeInt32(header + 2, clampToField(fileSize));
+    writeInt32(header + 10, static_cast<uint32_t>(pixelOffset));
+    writeInt32(header + 14, 40);                        // BITMAPINFOHEADER
+    writeInt32(header + 18, static_cast<uint32_t>(meta.width));
+    writeInt32(header + 22, static_cast<uint32_t>(meta.height));
+    writeInt16(header + 26, 1);                         // planes
+    writeInt16(header + 28, static_cast<uint16_t>(meta.bitDepth));
+    writeInt32(header + 34, clampToField(pixelBytes));
+    writeInt32(header + 38, 2835);                      // 72 DPI
+    writeInt32(header + 42, 2835);
+    writeInt32(header + 46, static_cast<uint32_t>(palette.size() / 4));
+
+    file_.open(filePath, std::ios::binary);
+    if (!file_) {
+        log(ERROR, "Failed to open file for writing: " + filePath);
+        return false;
+    }
+
+    file_.write(reinterpret_cast<const char*>(header), HEADER_SIZE);
+    file_.write(reinterpret_cast<const char*>(palette.data()), palette.size());
+    if (!file_) {
+        log(ERROR, "Failed to write image header.");
+        return false;
+    }
+    return true;
+}
+
+bool BmpBandWriter::writeRows(const uint8_t* src, int count) {
+    if (count < 0 || rowsWritten_ + count > meta_.height) {
+        log(ERROR, "Attempt to write past the last image row.");
+        return false;
+    }
+
+    size_t rowBytes = static_cast<size_t>(meta_.width) * (meta_.bitDepth / 8);
+    const char padding[4] = {0, 0, 0, 0};
+    size_t paddingBytes = paddedRowSize(meta_) - rowBytes;
+
+    for (int r = 0; r < count; ++r) {
+        file_.write(reinterpret_cast<const char*>(src + r * rowBytes), rowBytes);
+        file_.write(padding, paddingBytes);
+        ++rowsWritten_;
+    }
+
+    if (!file_) {
+        log(ERROR, "Failed to write pixel data.");
+        return false;
+    }
+    return true;
+}
+
+bool BmpBandWriter::close() {
+    file_.close();
+    if (rowsWritten_ != meta_.height) {
+        log(ERROR, "Image closed after " + std::to_string(rowsWritten_) + " of " +
+                   std::to_string(meta_.height) + " rows.");
+        return false;
+    }
+    if (file_.fail()) {
+        log(ERROR, "Failed to flush image file.");
+        return false;
+    }
+    log(INFO, "Image successfully written.");
+    return true;
+}
+
+// Streaming operations ----
+
+StreamingOperation streamingBoxFilter(int kernelSize) {
+    StreamingOperation operation;
+    operation.haloRows = kernelSize / 2;
+    operation.apply = [kernelSize](const ImageView& band) {
+        return applyBoxFilter(band, kernelSize);
+    };
+    return operation;
+}
+
+StreamingOperation streamingGaussianFilter(int kernelSize, double sigma) {
+    StreamingOperation operation;
+    operation.haloRows = kernelSize / 2;
+    operation.apply = [kernelSize, sigma](const ImageView& band) {
+        return applyGaussianFilter(band, kernelSize, sigma);
+    };
+    return operation;
+}
+
+StreamingOperation streamingMedianFilter(int kernelSize) {
+    StreamingOperation operation;
+    operation.haloRows = kernelSize / 2;
+    operation.apply = [kernelSize](const ImageView& band) {
+        return applyMedianFilter(band, kernelSize);
+    };
+    return operation;
+}
+
+StreamingOperation streamingErosion(int kernelColumns, int kernelRows) {
+    StreamingOperation operation;
+    operation.haloRows = kernelRows / 2;
+    operation.apply = [kernelColumns, kernelRows](const ImageView& band) {
+        return applyErosion(band, kernelColumns, kernelRows);
+    };
+    return operation;
+}
+
+StreamingOperation streamingDilation(int kernelColumns, int kernelRows) {
+    StreamingOperation operation;
+    operation.haloRows = kernelRows / 2;
+    operation.apply = [kernelColumns, kernelRows](const ImageView& band) {
+        return applyDilation(band, kernelColumns, kernelRows);
+    };
+    return operation;
+}
+
+StreamingOperation streamingOpening(int kernelColumns, int kernelRows) {
+    StreamingOperation operation;
+    operation.haloRows = 2 * (kernelRows / 2);   // the halo of a composition is the sum of both halos
+    operation.apply = [kernelColumns, kernelRows](const ImageView& band) {
+        return applyOpening(band, kernelColumns, kernelRows);
+    };
+    return operation;
+}
+
+StreamingOperation streamingClosing(int kernelColumns, int kernelRows) {
+    StreamingOperation operation;
+    operation.haloRows = 2 * (kernelRows / 2);   // the halo of a composition is the sum of both halos
+    operation.apply = [kernelColumns, kernelRows](const ImageView& band) {
+        return applyClosing(band, kernelColumns, kernelRows);
+    };
+    return operation;
+}
+
+StreamingOperation streamingGradientEdgeDetection(
+    KernelChoice kernelChoice,
+    bool applyThreshold,
+    double thresholdValue,
+    PaddingChoice paddingChoice,
+    GradientNorm norm
+) {
+    StreamingOperation operation;
+    operation.haloRows = 1;     // every gradient kernel reaches one row away
+
+    if (applyThreshold) {
+        operation.apply = [=](const ImageView& band) {
+            return applyGradientEdgeDetection(band, kernelChoice, true, thresholdValue, paddingChoice, norm);
+        };
+        return operation;
+    }
+
+    // Global range of the magnitudes, filled in by the measuring pass
+    struct Range {
+        float minVal = std::numeric_limits<float>::max();
+        float maxVal = std::numeric_limits<float>::lowest();
+    };
+    auto range = std::make_shared<Range>();
+
+    operation.measure = [=](const ImageView& band, int coreBegin, int coreEnd) {
+        std::vector<float> magnitudes = computeGradientMagnitude(band, kernelChoice, paddingChoice, norm);
+        auto first = magnitudes.begin() + static_cast<size_t>(coreBegin) * band.width;
+        auto last = magnitudes.begin() + static_cast<size_t>(coreEnd) * band.width;
+        auto [minIt, maxIt] = std::minmax_element(first, last);
+        range->minVal = std::min(range->minVal, *minIt);
+        range->maxVal = std::max(range->maxVal, *maxIt);
+    };
+    operation.apply = [=](const ImageView& band) {
+        return scaleGradientMagnitude(computeGradientMagnitude(band, kernelChoice, paddingChoice, norm), range->minVal, range->maxVal);
+    };
+    return operation;
+}
+
+// Band driver ----
+
+bool processImageInBands(
+    const std::string& inputPath,
+    const std::string& outputPath,
+    const StreamingOperation& operation,
+    int bandRows
+) {
+    if (bandRows <= 0 || operation.haloRows < 0 || !operation.apply) {
+        throw std::invalid_argument("Band size must be positive and the operation must be set!");
+    }
+
+    // Measuring pass for operations that depend on a global statistic
+    if (operation.measure) {
+        BmpBandReader reader;
+        if (!reader.open(inputPath)) {
+            return false;
+        }
+        if (reader.meta().bitDepth != 8) {
+            log(ERROR, "Streaming operations need an 8-bit grayscale image.");
+            return false;
+        }
+        if (!forEachBand(reader, operation.haloRows, bandRows, operation.measure)) {
+            return false;
+        }
+    }
+
+    BmpBandReader reader;
+    if (!reader.open(inputPath)) {
+        return false;
+    }
+    if (reader.meta().bitDepth != 8) {
+        log(ERROR, "Streaming operations need an 8-bit grayscale image.");
+        return false;
+    }
+
+    BmpBandWriter writer;
+    if (!writer.open(outputPath, reader.meta(), reader.colorTable())) {
+        return false;
+    }
+
+    bool written = true;
+    bool read = forEachBand(reader, operation.haloRows, bandRows,
+        [&](const ImageView& band, int coreBegin, int coreEnd) {
+            if (!written) {
+                return;
+            }
+            std::vector<uint8_t> output = operation.apply(band);
+            written = writer.writeRows(output.data() + static_cast<size_t>(coreBegin) * band.width, coreEnd - coreBegin);
+        });
+
+    return read && written && writer.close();
+}
+
+// Streaming CLAHE ----
+
+bool applyClaheInBands(
+    const std::string& inputPath,
+    const std::string& outputPath,
+    int tileSize,
+    double clipLimit
+) {
+    if (tileSize <= 0 || clipLimit < 0) {
+        throw std::invalid_argument("CLAHE needs a positive tile size and a non-negative clip limit!");
+    }
+
+    BmpBandReader reader;
+    if (!reader.open(inputPath)) {
+        return false;
+    }
+    if (reader.meta().bitDepth != 8) {
+        log(ERROR, "Streaming operations need an 8-bit grayscale image.");
+        return false;
+    }
+
+    BmpBandWriter writer;
+    if (!writer.open(outputPath, reader.meta(), reader.colorTable())) {
+        return false;
+    }
+
+    const int width = reader.meta().width;
+    const int height = reader.meta().height;
+    const ClaheInterpolator interpolator(width, height, tileSize);
+
+    // Pixels of one row of tiles, and its tables
+    struct TileRow {
+        std::vector<uint8_t> pixels;
+        std::vector<LookupTable> tables;
+        int rows = 0;
+    };
+    auto readTileRow = [&](int tileRow, TileRow& destination) {
+        destination.rows = std::min(tileSize, height - tileRow * tileSize);
+        destination.pixels.resize(static_cast<size_t>(destination.rows) * width);
+        if (!reader.readRows(destination.pixels.data(), destination.rows)) {
+            return false;
+        }
+        destination.tables = claheTileTables(makeImageView(static_cast<const uint8_t*>(destination.pixels.data()),
+                                                           width, destination.rows), tileSize, clipLimit);
+        return true;
+    };
+
+    // Rows of tile row t blend the tables of t - 1, t and t + 1, so reading runs one row of tiles ahead
+    TileRow previous, current, next;
+    if (!readTileRow(0, current)) {
+        return false;
+    }
+    for (int t = 0; t < interpolator.tileRows(); ++t) {
+        if (t + 1 < interpolator.tileRows() && !readTileRow(t + 1, next)) {
+            return false;
+        }
+
+        auto tablesOf = [&](int tileRow) {
+            return (tileRow < t) ? previous.tables.data() : (tileRow == t) ? current.tables.data() : next.tables.data();
+        };
+        for (int i = 0; i < current.rows; ++i) {
+            int row = t * tileSize + i;
+            uint8_t* pixels = current.pixels.data() + static_cast<size_t>(i) * width;
+            interpolator.mapRow(row, pixels, pixels, tablesOf(interpolator.upperTileRow(row)), tablesOf(interpolator.lowerTileRow(row)));
+        }
+        if (!writer.writeRows(current.pixels.data(), current.rows)) {
+            return false;
+        }
+
+        std::swap(previous, current);
+        std::swap(current, next);
+    }
+
+    return writer.close();
+}
@@ -0,0 +1,65 @@
+#include "IntegralImage.h"
+#include <algorithm>
+#include <stdexcept>
+
+IntegralImage::IntegralImage(const uint8_t* buffer, int width, int height)
+    : width_(width), height_(height) {
+
+    if (buffer == nullptr || width <= 0 || height <= 0) {
+        throw std::invalid_argument("Invalid buffer or dimensions for integral image!");
+    }
+    table_.assign(static_cast<size_t>(width + 1) * (height + 1), 0);
+
+    // table(r + 1, c + 1) = sum of all pixels in rows [0, r] and columns [0, c]
+    for (int r = 0; r < height; ++r) {
+        const uint8_t* src = buffer + static_cast<size_t>(r) * width;
+        const uint64_t* above = &table_[static_cast<size_t>(r) * (width + 1)];
+        uint64_t* current = &table_[static_cast<size_t>(r + 1) * (width + 1)];
+
+        uint64_t rowSum = 0;
+        for (int c = 0; c < width; ++c) {
+            rowSum += src[c];
+            current[c + 1] = above[c + 1] + rowSum;
+        }
+    }
+}
+
+IntegralImage::IntegralImage(const ImageReadResult& inputImage)
+    : IntegralImage(inputImage.buffer ? inputImage.buffer->data() : nullptr,
+                    inputImage.meta.width, inputImage.meta.height) {}
+
+uint64_t IntegralImage::sum(int top, int left, int bottom, int right) const {
+    top = std::max(top, 0);
+    left = std::max(left, 0);
+    bottom = std::min(bottom, height_ - 1);
+    right = std::min(right, width_ - 1);
+
+    if (top > bottom || left > right) {
+        return 0;
+    }
+
+    return at(bottom + 1, right + 1) - at(top, right + 1) - at(bottom + 1, left) + at(top, left);
+}
+
+int64_t IntegralImage::count(int top, int left, int bottom, int right) const {
+    top = std::max(top, 0);
+    left = std::max(left, 0);
+    bottom = std::min(bottom, height_ - 1);
+    right = std::min(right, width_ - 1);
+
+    if (top > bottom || left > right) {
+        return 0;
+    }
+
+    return static_cast<int64_t>(bottom - top + 1) * (right - left + 1);
+}
+
+double IntegralImage::localMean(int row, int col, int halfKernel) const {
+    int top = row - halfKernel;
+    int left = col - halfKernel;
+    int bottom = row + halfKernel;
+    int right = col + halfKernel;
+
+    int64_t n = count(top, left, bottom, right);
+    return (n > 0) ? static_cast<double>(sum(top, left, bottom, right)) / n : 0.0;
+}
@@ -1,70 +1,62 @@
 #include "IntensityTransformations.h"
-#include <cmath> // For log, pow
+#include "LookupTable.h"
+#include <algorithm>
+
+/* Every transformation here is a 256-entry table applied in place (see LookupTable.h), so log() and pow()
+ * run 256 times instead of once per pixel. The tables work per 8-bit sample, so 24-bit images are
+ * transformed channel by channel.
+ */
+
+namespace {
+
+// 8-bit samples in the buffer: one per pixel for grayscale, three for 24-bit
+size_t sampleCount(const ImageMetadata &meta) {
+    return static_cast<size_t>(meta.width) * meta.height * std::max(1, meta.bitDepth / 8);
+}
+
+} // namespace
 
 void applyNegative(uint8_t *buffer, const ImageMetadata &meta) {
 
     std::cout << "Aplying Negative Transformation...\n";
 
-    int maxVal = (1 << meta.bitDepth) - 1;
-    for (int i = 0; i < meta.width * meta.height; i++) {
-        buffer[i] = maxVal - buffer[i];
-    }
+    applyLookupTable(negativeTable(), buffer, buffer, sampleCount(meta));
 
     std::cout << "Completed Negative Transformation...\n";
 }
 
 void applyLogTransform(uint8_t *buffer, const ImageMetadata &meta) {
-    int maxVal = (1 << meta.bitDepth) - 1;
-
     double c = 0.0;
     std::cout << "Type the C value (type -1 if you want to use the default value): ";
     std::cin >> c;
-    if (c == -1)
-    {
-        c = 255.0 / log(1 + 255.0); //default value
-    }
 
+    applyLogTransform(buffer, meta, c);
+}
+
+void applyLogTransform(uint8_t *buffer, const ImageMetadata &meta, double c) {
     std::cout << "\n Applying Log Transformation...\n";
 
-    for (int i = 0; i < meta.width * meta.height; i++) {
-        double transformedValue = c * log(1 + buffer[i]);
-        if (transformedValue > maxVal) {
-            transformedValue = maxVal; // Clamp the value
-        }
-        buffer[i] = static_cast<uint8_t>(transformedValue);
-    }
+    applyLookupTable(logTable(c), buffer, buffer, sampleCount(meta));
 
     std::cout << "Completed Log Transformation...\n";
 }
 
 void applyGammaTransform(uint8_t *buffer, const ImageMetadata &meta) {
-    int maxVal = (1 << meta.bitDepth) - 1;
-
     double c = 0.0;
     std::cout << "Type the C value (type -1 if you want to use the default value): ";
     std::cin >> c;
-    if (c == -1)
-    {
-        c = 255.0 / log(1 + 255.0);
-    }
 
-    double gamma = 0.1; //default value
+    double gamma = 0.0;
     std::cout << "\nType the Gamma value (type -1 if you want to use the default value): ";
-    std::cin >> c;
-    if (gamma == -1)
-    {
-        gamma = 0.1;
-    }
+    std::cin >> gamma;
+
+    applyGammaTransform(buffer, meta, c, gamma);
+}
 
+void applyGammaTransform(uint8_t *buffer, const ImageMetadata &meta, double c, double gamma) {
     std::cout << "\n Applying Gamma Transformation...\n";
 
-    for (int i = 0; i < meta.width * meta.height; i++) {
-        double transformedValue = c * pow(buffer[i], gamma);
-        if (transformedValue > maxVal) {
-            transformedValue = maxVal; // Clamp the value
-        }
-        buffer[i] = static_cast<uint8_t>(transformedValue);
-    }
+    applyLookupTable(gammaTable(c, gamma), buffer, buffer, sampleCount(meta));
 
     std::cout << "Completed Gamma Transformation...\n";
 }
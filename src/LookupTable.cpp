@@ -0,0 +1,231 @@
+#include "LookupTable.h"
+#include "Convolution3x3.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define LOOKUP_X86_DISPATCH 1
+#include <immintrin.h>
+#endif
+
+// Tables ----
+
+LookupTable LookupTable::identity() {
+    LookupTable table;
+    for (int v = 0; v < 256; ++v) {
+        table.values[v] = static_cast<uint8_t>(v);
+    }
+    return table;
+}
+
+LookupTable LookupTable::then(const LookupTable& next) const {
+    LookupTable composed;
+    for (int v = 0; v < 256; ++v) {
+        composed.values[v] = next.values[values[v]];
+    }
+    return composed;
+}
+
+namespace {
+
+// Same rounding the per-pixel loops used: clamp, then truncate
+uint8_t clampToByte(double value) {
+    return static_cast<uint8_t>(std::clamp(value, 0.0, 255.0));
+}
+
+} // namespace
+
+LookupTable negativeTable() {
+    LookupTable table;
+    for (int v = 0; v < 256; ++v) {
+        table.values[v] = static_cast<uint8_t>(255 - v);
+    }
+    return table;
+}
+
+LookupTable logTable(double c) {
+    if (c == -1) {
+        c = 255.0 / std::log(1 + 255.0);   // default value
+    }
+
+    LookupTable table;
+    for (int v = 0; v < 256; ++v) {
+        table.values[v] = clampToByte(c * std::log(1 + v));
+    }
+    return table;
+}
+
+LookupTable gammaTable(double c, double gamma) {
+    if (c == -1) {
+        c = 255.0 / std::log(1 + 255.0);
+    }
+    if (gamma == -1) {
+        gamma = 0.1;   // default value
+    }
+
+    LookupTable table;
+    for (int v = 0; v < 256; ++v) {
+        table.values[v] = clampToByte(c * std::pow(v, gamma));
+    }
+    return table;
+}
+
+LookupTable thresholdTable(int threshold) {
+    LookupTable table;
+    for (int v = 0; v < 256; ++v) {
+        table.values[v] = (v > threshold) ? 255 : 0;
+    }
+    return table;
+}
+
+std::vector<uint64_t> remapHistogram(const std::vector<uint64_t>& histogram, const LookupTable& table) {
+    if (histogram.size() != 256) {
+        throw std::invalid_argument("remapHistogram needs a 256-bin histogram!");
+    }
+
+    std::vector<uint64_t> remapped(256, 0);
+    for (int v = 0; v < 256; ++v) {
+        remapped[table(static_cast<uint8_t>(v))] += histogram[v];
+    }
+    return remapped;
+}
+
+// Lookup engines ----
+
+namespace {
+
+void lookupScalar(const uint8_t* table, const uint8_t* input, uint8_t* output, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        output[i] = table[input[i]];
+    }
+}
+
+#ifdef LOOKUP_X86_DISPATCH
+
+// pshufb looks up 16 entries by the low nibble; block k of the table is kept where the high nibble is k
+__attribute__((target("sse4.1")))
+void lookupSse41(const uint8_t* table, const uint8_t* input, uint8_t* output, size_t count) {
+    __m128i blocks[16];
+    for (int k = 0; k < 16; ++k) {
+        blocks[k] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(table + 16 * k));
+    }
+    const __m128i nibbleMask = _mm_set1_epi8(0x0F);
+
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+        __m128i low = _mm_and_si128(pixels, nibbleMask);
+        __m128i high = _mm_and_si128(_mm_srli_epi16(pixels, 4), nibbleMask);
+
+        __m128i result = _mm_setzero_si128();
+        for (int k = 0; k < 16; ++k) {
+            __m128i selected = _mm_cmpeq_epi8(high, _mm_set1_epi8(static_cast<char>(k)));
+            result = _mm_or_si128(result, _mm_and_si128(selected, _mm_shuffle_epi8(blocks[k], low)));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), result);
+    }
+    lookupScalar(table, input + i, output + i, count - i);
+}
+
+// Same as SSE4.1; vpshufb works within 128-bit lanes, so every block is broadcast to both lanes
+__attribute__((target("avx2")))
+void lookupAvx2(const uint8_t* table, const uint8_t* input, uint8_t* output, size_t count) {
+    __m256i blocks[16];
+    for (int k = 0; k < 16; ++k) {
+        blocks[k] = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(table + 16 * k)));
+    }
+    const __m256i nibbleMask = _mm256_set1_epi8(0x0F);
+
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i));
+        __m256i low = _mm256_and_si256(pixels, nibbleMask);
+        __m256i high = _mm256_and_si256(_mm256_srli_epi16(pixels, 4), nibbleMask);
+
+        __m256i result = _mm256_setzero_si256();
+        for (int k = 0; k < 16; ++k) {
+            __m256i selected = _mm256_cmpeq_epi8(high, _mm256_set1_epi8(static_cast<char>(k)));
+            result = _mm256_or_si256(result, _mm256_and_si256(selected, _mm256_shuffle_epi8(blocks[k], low)));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i), result);
+    }
+    lookupScalar(table, input + i, output + i, count - i);
+}
+
+// vpermi2b indexes 128 bytes held in two registers with the low 7 bits; bit 7 picks the half
+__attribute__((target("avx512f,avx512bw,avx512vbmi")))
+inline __m512i lookup64(const __m512i quarters[4], __m512i pixels) {
+    __m512i lowHalf = _mm512_permutex2var_epi8(quarters[0], pixels, quarters[1]);
+    __m512i highHalf = _mm512_permutex2var_epi8(quarters[2], pixels, quarters[3]);
+    return _mm512_mask_blend_epi8(_mm512_movepi8_mask(pixels), lowHalf, highHalf);
+}
+
+__attribute__((target("avx512f,avx512bw,avx512vbmi")))
+void lookupAvx512Vbmi(const uint8_t* table, const uint8_t* input, uint8_t* output, size_t count) {
+    __m512i quarters[4];
+    for (int q = 0; q < 4; ++q) {
+        quarters[q] = _mm512_loadu_si512(table + 64 * q);
+    }
+
+    size_t i = 0;
+    for (; i + 64 <= count; i += 64) {
+        _mm512_storeu_si512(output + i, lookup64(quarters, _mm512_loadu_si512(input + i)));
+    }
+
+    // Masked tail instead of a scalar loop
+    if (i < count) {
+        __mmask64 tail = (~0ULL) >> (64 - (count - i));
+        _mm512_mask_storeu_epi8(output + i, tail, lookup64(quarters, _mm512_maskz_loadu_epi8(tail, input + i)));
+    }
+}
+
+bool cpuHasVbmi() {
+    static const bool supported = [] {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx512vbmi") != 0;
+    }();
+    return supported;
+}
+
+#endif // LOOKUP_X86_DISPATCH
+
+} // namespace
+
+void applyLookupTable(const LookupTable& table, const uint8_t* input, uint8_t* output, size_t count) {
+    switch (activeSimdLevel()) {
+#ifdef LOOKUP_X86_DISPATCH
+        case SimdLevel::AVX512:
+            if (cpuHasVbmi()) {
+                lookupAvx512Vbmi(table.values, input, output, count);
+                return;
+            }
+            lookupAvx2(table.values, input, output, count);   // AVX-512BW without VBMI
+            return;
+        case SimdLevel::AVX2:
+            lookupAvx2(table.values, input, output, count);
+            return;
+        case SimdLevel::SSE41:
+            lookupSse41(table.values, input, output, count);
+            return;
+#endif
+        default:
+            lookupScalar(table.values, input, output, count);
+            return;
+    }
+}
+
+void applyLookupTable(const LookupTable& table, const ImageView& input, const MutableImageView& output) {
+    if (!input.isValid()) {
+        throw std::invalid_argument("Lookup table needs a valid view!");
+    }
+    requireSameSize(input, output);
+
+    size_t rowLength = static_cast<size_t>(input.width) * input.channels;
+    parallelRowRanges(input.height, 64, [&](int rowBegin, int rowEnd) {
+        for (int r = rowBegin; r < rowEnd; ++r) {
+            applyLookupTable(table, input.row(r), output.row(r), rowLength);
+        }
+    });
+}
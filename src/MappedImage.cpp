@@ -0,0 +1,155 @@
+#include "MappedImage.h"
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+// BMP fields are little-endian and not necessarily aligned inside the mapping
+int32_t readInt32(const uint8_t* bytes) {
+    int32_t value;
+    std::memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+int16_t readInt16(const uint8_t* bytes) {
+    int16_t value;
+    std::memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+} // namespace
+
+MappedImage::~MappedImage() {
+    release();
+}
+
+MappedImage::MappedImage(MappedImage&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedImage& MappedImage::operator=(MappedImage&& other) noexcept {
+    if (this != &other) {
+        release();
+        mapping_ = std::exchange(other.mapping_, nullptr);
+        mappingSize_ = std::exchange(other.mappingSize_, 0);
+        meta_ = other.meta_;
+        view_ = std::exchange(other.view_, ImageView{});
+        colorTable_ = std::exchange(other.colorTable_, nullptr);
+        colorTableSize_ = std::exchange(other.colorTableSize_, 0);
+    }
+    return *this;
+}
+
+void MappedImage::release() {
+    if (mapping_ != nullptr) {
+        munmap(mapping_, mappingSize_);
+        mapping_ = nullptr;
+        mappingSize_ = 0;
+    }
+}
+
+ImageReadResult MappedImage::toImageReadResult() const {
+    ImageReadResult result;
+    if (!isValid()) {
+        return result;
+    }
+
+    size_t rowBytes = static_cast<size_t>(view_.width) * view_.channels;
+    std::vector<uint8_t> buffer(rowBytes * view_.height);
+    for (int r = 0; r < view_.height; ++r) {
+        std::memcpy(buffer.data() + r * rowBytes, view_.row(r), rowBytes);
+    }
+
+    result.buffer = std::move(buffer);
+    result.colorTable.assign(colorTable_, colorTable_ + colorTableSize_);
+    result.header.assign(header(), header() + HEADER_SIZE);
+    result.meta = meta_;
+    return result;
+}
+
+MappedImage mapImage(const std::string& filePath) {
+    log(INFO, "Mapping file: " + filePath);
+
+    int fd = ::open(filePath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        log(ERROR, "Failed to open file: " + filePath);
+        return {};
+    }
+
+    struct stat fileInfo;
+    if (fstat(fd, &fileInfo) != 0 || fileInfo.st_size < static_cast<off_t>(HEADER_SIZE)) {
+        log(ERROR, "File is too small to be a BMP file: " + filePath);
+        ::close(fd);
+        return {};
+    }
+
+    size_t fileSize = static_cast<size_t>(fileInfo.st_size);
+    void* mapping = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // the mapping keeps its own reference to the file
+    if (mapping == MAP_FAILED) {
+        log(ERROR, "Failed to map file: " + filePath);
+        return {};
+    }
+    madvise(mapping, fileSize, MADV_SEQUENTIAL);
+
+    MappedImage image;
+    image.mapping_ = mapping;
+    image.mappingSize_ = fileSize;
+
+    const uint8_t* bytes = static_cast<const uint8_t*>(mapping);
+
+    // Validate BMP signature
+    if (bytes[0] != 'B' || bytes[1] != 'M') {
+        log(ERROR, "File is not a valid BMP file.");
+        return {};
+    }
+
+    // Extract metadata
+    size_t pixelOffset = static_cast<uint32_t>(readInt32(bytes + 10));
+    image.meta_.width = readInt32(bytes + 18);
+    image.meta_.height = readInt32(bytes + 22);
+    image.meta_.bitDepth = readInt16(bytes + 28);
+
+    if (!image.meta_.isValid()) {
+        log(ERROR, "Invalid metadata extracted from image header.");
+        return {};
+    }
+
+    if (image.meta_.bitDepth != 8 && image.meta_.bitDepth != 24) {
+        log(ERROR, "Unsupported bit depth: " + std::to_string(image.meta_.bitDepth));
+        return {};
+    }
+
+    // Rows are padded to a multiple of 4 bytes in the file
+    int channels = image.meta_.bitDepth / 8;
+    size_t stride = ((static_cast<size_t>(image.meta_.width) * image.meta_.bitDepth + 31) / 32) * 4;
+    size_t pixelBytes = stride * image.meta_.height;
+
+    if (pixelOffset < HEADER_SIZE || pixelOffset > fileSize || fileSize - pixelOffset < pixelBytes) {
+        log(ERROR, "Pixel data is truncated or out of range in: " + filePath);
+        return {};
+    }
+
+    // The color table sits between the header and the pixel data
+    if (image.meta_.bitDepth <= 8) {
+        image.colorTable_ = bytes + HEADER_SIZE;
+        image.colorTableSize_ = std::min(COLOR_TABLE_SIZE, pixelOffset - HEADER_SIZE);
+    }
+
+    image.view_.data = bytes + pixelOffset;
+    image.view_.width = image.meta_.width;
+    image.view_.height = image.meta_.height;
+    image.view_.stride = static_cast<std::ptrdiff_t>(stride);
+    image.view_.channels = channels;
+
+    log(INFO, "Image Metadata: Width=" + std::to_string(image.meta_.width) +
+              ", Height=" + std::to_string(image.meta_.height) +
+              ", Bit Depth=" + std::to_string(image.meta_.bitDepth));
+
+    return image;
+}
@@ -0,0 +1,112 @@
+#include "PackedBinaryImage.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+constexpr uint64_t LOW_7_BITS = 0x7F7F7F7F7F7F7F7FULL;
+constexpr uint64_t HIGH_BITS = 0x8080808080808080ULL;
+constexpr uint64_t GATHER_MAGIC = 0x0102040810204080ULL;
+
+// 8 pixels -> 8 bits: the high bit of each byte is set iff the byte is non-zero, then one multiply
+// moves the 8 high bits into the top byte (byte k -> bit k)
+inline uint64_t packEightPixels(const uint8_t* pixels) {
+    uint64_t v;
+    std::memcpy(&v, pixels, sizeof(v));
+    uint64_t nonZero = (((v & LOW_7_BITS) + LOW_7_BITS) | v) & HIGH_BITS;
+    return ((nonZero >> 7) * GATHER_MAGIC) >> 56;
+}
+
+// 8 bits -> 8 bytes of 0/255, one table entry per bit pattern
+const std::array<uint64_t, 256>& unpackTable() {
+    static const std::array<uint64_t, 256> table = [] {
+        std::array<uint64_t, 256> t{};
+        for (int bits = 0; bits < 256; ++bits) {
+            for (int k = 0; k < 8; ++k) {
+                if (bits & (1 << k)) t[bits] |= uint64_t(0xFF) << (8 * k);
+            }
+        }
+        return t;
+    }();
+    return table;
+}
+
+} // namespace
+
+PackedBinaryImage::PackedBinaryImage(int width, int height)
+    : width_(width), height_(height), wordsPerRow_((width + 63) / 64) {
+    if (width <= 0 || height <= 0) {
+        throw std::invalid_argument("Invalid dimensions for packed binary image!");
+    }
+    words_.assign(static_cast<size_t>(wordsPerRow_) * height, 0);
+}
+
+PackedBinaryImage::PackedBinaryImage(const uint8_t* buffer, int width, int height)
+    : PackedBinaryImage(width, height) {
+    if (buffer == nullptr) {
+        throw std::invalid_argument("Missing buffer for packed binary image!");
+    }
+
+    for (int r = 0; r < height_; ++r) {
+        packRow(r, buffer + static_cast<size_t>(r) * width_);
+    }
+}
+
+void PackedBinaryImage::packRow(int r, const uint8_t* pixels) {
+    uint64_t* dst = row(r);
+    std::fill(dst, dst + wordsPerRow_, 0);
+
+    int c = 0;
+    // Whole words: 8 groups of 8 pixels
+    for (; c + 64 <= width_; c += 64) {
+        uint64_t word = 0;
+        for (int group = 0; group < 8; ++group) {
+            word |= packEightPixels(pixels + c + 8 * group) << (8 * group);
+        }
+        dst[c >> 6] = word;
+    }
+    // Tail of the row
+    for (; c < width_; ++c) {
+        if (pixels[c] != 0) dst[c >> 6] |= uint64_t(1) << (c & 63);
+    }
+}
+
+PackedBinaryImage::PackedBinaryImage(const ImageReadResult& inputImage)
+    : PackedBinaryImage(inputImage.buffer ? inputImage.buffer->data() : nullptr,
+                        inputImage.meta.width, inputImage.meta.height) {}
+
+void PackedBinaryImage::toBuffer(uint8_t* output) const {
+    const auto& table = unpackTable();
+
+    for (int r = 0; r < height_; ++r) {
+        const uint64_t* src = row(r);
+        uint8_t* dst = output + static_cast<size_t>(r) * width_;
+
+        int c = 0;
+        for (; c + 64 <= width_; c += 64) {
+            uint64_t word = src[c >> 6];
+            for (int group = 0; group < 8; ++group) {
+                std::memcpy(dst + c + 8 * group, &table[(word >> (8 * group)) & 0xFF], 8);
+            }
+        }
+        for (; c < width_; ++c) {
+            dst[c] = ((src[c >> 6] >> (c & 63)) & 1u) ? 255 : 0;
+        }
+    }
+}
+
+std::vector<uint8_t> PackedBinaryImage::toBuffer() const {
+    std::vector<uint8_t> output(static_cast<size_t>(width_) * height_);
+    toBuffer(output.data());
+    return output;
+}
+
+size_t PackedBinaryImage::countForeground() const {
+    size_t count = 0;
+    for (uint64_t word : words_) {
+        count += static_cast<size_t>(__builtin_popcountll(word));
+    }
+    return count;
+}
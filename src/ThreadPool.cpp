@@ -0,0 +1,169 @@
+#include "ThreadPool.h"
+#include <exception>
+
+struct ThreadPool::Batch {
+    const std::function<void(int)>* task;
+    int remaining;
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::exception_ptr error;
+};
+
+ThreadPool::ThreadPool(int threadCount) {
+    if (threadCount <= 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for (int i = 0; i < threadCount - 1; ++i) {
+        queues_.push_back(std::make_unique<TaskQueue>());
+    }
+    for (int i = 0; i < threadCount - 1; ++i) {
+        workers_.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        stopping_ = true;
+    }
+    wakeUp_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+}
+
+bool ThreadPool::popOwn(int queueIndex, Task& task) {
+    TaskQueue& queue = *queues_[queueIndex];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    task = queue.tasks.back();
+    queue.tasks.pop_back();
+    --queuedTasks_;
+    return true;
+}
+
+bool ThreadPool::steal(int thiefIndex, Task& task) {
+    int queueCount = static_cast<int>(queues_.size());
+    for (int offset = 1; offset <= queueCount; ++offset) {
+        TaskQueue& queue = *queues_[(thiefIndex + offset) % queueCount];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = queue.tasks.front();
+            queue.tasks.pop_front();
+            --queuedTasks_;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::run(const Task& task) {
+    Batch& batch = *task.batch;
+    std::exception_ptr error;
+    try {
+        (*batch.task)(task.index);
+    } catch (...) {
+        error = std::current_exception();
+    }
+
+    // The batch lives on the caller's stack: it may be gone as soon as the lock is released
+    std::lock_guard<std::mutex> lock(batch.mutex);
+    if (error && !batch.error) {
+        batch.error = error;
+    }
+    if (--batch.remaining == 0) {
+        batch.finished.notify_all();
+    }
+}
+
+void ThreadPool::workerLoop(int queueIndex) {
+    Task task;
+    while (true) {
+        if (popOwn(queueIndex, task) || steal(queueIndex, task)) {
+            run(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        wakeUp_.wait(lock, [this] { return stopping_ || queuedTasks_.load() > 0; });
+        if (stopping_ && queuedTasks_.load() == 0) {
+            return;
+        }
+    }
+}
+
+void ThreadPool::parallelFor(int taskCount, const std::function<void(int)>& task) {
+    if (taskCount <= 0) {
+        return;
+    }
+    if (workers_.empty()) {
+        for (int i = 0; i < taskCount; ++i) {
+            task(i);
+        }
+        return;
+    }
+
+    Batch batch;
+    batch.task = &task;
+    batch.remaining = taskCount;
+
+    // Consecutive indices go to the same worker, so neighbouring bands tend to stay on one core
+    int queueCount = static_cast<int>(queues_.size());
+    for (int q = 0; q < queueCount; ++q) {
+        int begin = static_cast<int>(static_cast<int64_t>(taskCount) * q / queueCount);
+        int end = static_cast<int>(static_cast<int64_t>(taskCount) * (q + 1) / queueCount);
+        if (begin == end) {
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(queues_[q]->mutex);
+        for (int i = begin; i < end; ++i) {
+            queues_[q]->tasks.push_back(Task{&batch, i});
+        }
+        queuedTasks_ += end - begin;
+    }
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+    }
+    wakeUp_.notify_all();
+
+    // The caller steals as well; this also keeps nested parallelFor calls from deadlocking
+    Task stolen;
+    while (steal(0, stolen)) {
+        run(stolen);
+    }
+
+    std::unique_lock<std::mutex> lock(batch.mutex);
+    batch.finished.wait(lock, [&batch] { return batch.remaining == 0; });
+    if (batch.error) {
+        std::rethrow_exception(batch.error);
+    }
+}
+
+// Shared pool ----
+
+namespace {
+
+std::mutex sharedPoolMutex;
+std::unique_ptr<ThreadPool> sharedPool;
+
+} // namespace
+
+ThreadPool& sharedThreadPool() {
+    std::lock_guard<std::mutex> lock(sharedPoolMutex);
+    if (!sharedPool) {
+        sharedPool = std::make_unique<ThreadPool>();
+    }
+    return *sharedPool;
+}
+
+void setThreadCount(int threadCount) {
+    std::lock_guard<std::mutex> lock(sharedPoolMutex);
+    sharedPool = std::make_unique<ThreadPool>(threadCount);
+}
+
+int getThreadCount() {
+    return sharedThreadPool().threadCount();
+}
@@ -86,6 +86,7 @@ int main() {
                 << "1. Histogram Calculation\n"
                 << "2. Histogram Equatiization\n"
                 << "3. Histogram Specification\n"
+                << "4. Contrast-Limited Adaptive Equalization (CLAHE)\n"
                 << "Type the number:";
 
         int choice2;
@@ -121,6 +122,36 @@ int main() {
             result.buffer =  histogramEqualization(result);
 
             break;
+
+        case 3: {
+            std::string referencePath;
+            std::cout << "Enter the reference image or histogram file (.csv): ";
+            std::cin >> referencePath;
+
+            try {
+                std::vector<double> referenceCdf = cumulativeDistribution(loadReferenceHistogram(referencePath));
+                result.buffer = histogramSpecification(result, referenceCdf);
+            } catch (const std::exception& e) {
+                std::cerr << "Error: " << e.what() << std::endl;
+            }
+            break;
+        }
+
+        case 4: {
+            int tileSize;
+            double clipLimit;
+            std::cout << "Enter the tile size in pixels (e.g. 64): ";
+            std::cin >> tileSize;
+            std::cout << "Enter the clip limit (e.g. 2.0, 0 for no limit): ";
+            std::cin >> clipLimit;
+
+            try {
+                result.buffer = applyCLAHE(result, tileSize, clipLimit);
+            } catch (const std::exception& e) {
+                std::cerr << "Error: " << e.what() << std::endl;
+            }
+            break;
+        }
         
         default:
             break;
@@ -230,6 +261,8 @@ int main() {
     case 4: {
         std::cout << "What type of conversion you want to perform?\n"
                     << "1. Grayscale to Binary\n"
+                    << "2. Grayscale to Binary, automatic threshold (Otsu)\n"
+                    << "3. Grayscale to Binary, adaptive threshold\n"
                     << "Type the number: ";
 
         int conversionChoice;
@@ -250,6 +283,39 @@ int main() {
                     std::cerr << "Error: " << e.what() << std::endl;
                 }
         }
+        else if (conversionChoice == 2)
+        {
+            try {
+                    result.buffer = applyOtsuThreshold(result);
+                } catch (const std::exception& e) {
+                    std::cerr << "Error: " << e.what() << std::endl;
+                }
+        }
+        else if (conversionChoice == 3)
+        {
+            std::cout << "Choose the method - \n"
+                    << "1. Mean\n"
+                    << "2. Gaussian\n"
+                    << "3. Niblack\n"
+                    << "4. Sauvola\n";
+            int methodChoice;
+            std::cin >> methodChoice;
+            std::cout << "Enter the window size (odd, e.g. 15): ";
+            int windowSize;
+            std::cin >> windowSize;
+
+            AdaptiveThresholdMethod method = AdaptiveThresholdMethod::MEAN;
+            if (methodChoice == 2) method = AdaptiveThresholdMethod::GAUSSIAN;
+            if (methodChoice == 3) method = AdaptiveThresholdMethod::NIBLACK;
+            if (methodChoice == 4) method = AdaptiveThresholdMethod::SAUVOLA;
+            double k = (method == AdaptiveThresholdMethod::SAUVOLA) ? DEFAULT_SAUVOLA_K : DEFAULT_NIBLACK_K;
+
+            try {
+                    result.buffer = applyAdaptiveThreshold(result, method, windowSize, k);
+                } catch (const std::exception& e) {
+                    std::cerr << "Error: " << e.what() << std::endl;
+                }
+        }
         break;
     }
     case 5: {
@@ -260,6 +326,7 @@ int main() {
               << "4. Closing\n"
               << "5. Boundary Extraction\n"
               << "6. Hole Filling\n"
+              << "7. Automatic Hole Filling\n"
               << "Type the number: ";
 
         int morphChoice;
@@ -314,6 +381,10 @@ int main() {
                 std::cout << "Performing Hole Filing...\n";
                 morphResult = applyHoleFilling(result, {seedRow, seedCol}, kernelColumnSize, kernelRowSize);
                 break;
+            case 7:
+                std::cout << "Performing Automatic Hole Filling...\n";
+                morphResult = applyAutomaticHoleFilling(result, kernelColumnSize, kernelRowSize);
+                break;
             default:
                 std::cerr << "Invalid choice for morphological operation." << std::endl;
                 break;
@@ -374,15 +445,49 @@ int main() {
         }else if (method == 2)
         {
             std::cout << "Applying Laplacian: \n";
-            
+
+            int methodChoice;
+            std::cout << "Select method:\n1. Laplacian of Gaussian\n2. Difference of Gaussians\nChoice: ";
+            std::cin >> methodChoice;
+
+            LaplacianMethod laplacianMethod = (methodChoice == 2) ? LaplacianMethod::DOG : LaplacianMethod::LOG;
+
+            double sigma;
+            std::cout << "Enter the sigma value for Gaussian filter: ";
+            std::cin >> sigma;
+
+            double slopeThreshold;
+            std::cout << "Enter the minimum slope across a zero crossing (0 keeps all): ";
+            std::cin >> slopeThreshold;
+
+            int paddingChoiceInt;
+            std::cout << "Select padding:\n0. None\n1. Zero\n2. Replicate\n3. Reflect\nChoice: ";
+            std::cin >> paddingChoiceInt;
+
+            PaddingChoice padC = static_cast<PaddingChoice>(paddingChoiceInt);      // casting the int padding choice into PaddingChoice type
+
+            std::vector<uint8_t> edgeBuffer = applyLaplacianEdgeDetection(result, sigma, slopeThreshold, laplacianMethod, padC);
+
+            // Update the result buffer
+            if (!edgeBuffer.empty()) {
+                result.buffer = edgeBuffer;
+            }
+
         }else if (method == 3)
         {
             std::cout << "Performing Canny Edge Detection...\n";
 
-            int kernelSizeGaussian;
+            int smoothingChoice;
+            std::cout << "Select Gaussian filter:\n1. Separable\n2. Recursive (any sigma, same cost)\nChoice: ";
+            std::cin >> smoothingChoice;
+
+            GaussianEngine smoothing = (smoothingChoice == 2) ? GaussianEngine::RECURSIVE : GaussianEngine::SEPARABLE;
 
-            std::cout << "Enter the kernel size for Gaussian filter: ";
-            std::cin >> kernelSizeGaussian;
+            int kernelSizeGaussian = 0;
+            if (smoothing == GaussianEngine::SEPARABLE) {
+                std::cout << "Enter the kernel size for Gaussian filter: ";
+                std::cin >> kernelSizeGaussian;
+            }
 
             int sigmaGaussian;
             std::cout << "Enter the sigma value for Gaussian filter: ";
@@ -402,7 +507,8 @@ int main() {
 
             PaddingChoice padC = static_cast<PaddingChoice>(paddingChoiceInt);      // casting the int padding choice into PaddingChoice type
 
-            std::vector<uint8_t> edgeBuffer = applyCannyEdgeDetection(result, lowThreshold, highThreshold, sigmaGaussian, kernelSizeGaussian, padC);
+            std::vector<uint8_t> edgeBuffer = applyCannyEdgeDetection(result, lowThreshold, highThreshold, sigmaGaussian, kernelSizeGaussian, padC,
+                                                                      CannyEngine::FUSED, smoothing);
 
             // Update the result buffer
             if (!edgeBuffer.empty()) {